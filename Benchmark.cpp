@@ -0,0 +1,361 @@
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Engine/Physics/core.hpp"
+#include "Engine/Math/headers/Vector.hpp"
+#include "Engine/Math/headers/Operation.hpp"
+#include "Utils/StopWatch.hpp"
+
+// Benchmarks of the engine's hot paths at three layers:
+//   math      Math::Vector operators and Math::Operation helpers, ns per operation
+//   kernel    one acceleration evaluation per solver at N = 10 ... 100k, ns per interaction
+//   scenario  World::step on data/sims/*.csv, generated disks and Plummer clusters, steps per second
+// Results are written as JSON or CSV (chosen by the output extension) so runs can be compared.
+// Only Engine/Physics and Engine/Math are needed to build it.
+
+struct BenchmarkResult {
+    std::string layer;
+    std::string name;
+    size_t bodies = 0;
+    size_t iterations = 0;
+    double secondsPerIteration = 0.0;
+    double nsPerOperation = 0.0;        ///< Math layer
+    double nsPerInteraction = 0.0;      ///< Kernel layer, time / (N (N - 1)) even for approximate solvers
+    double stepsPerSecond = 0.0;        ///< Scenario layer
+    double maxRelativeError = -1.0;     ///< Against DirectSolver, -1 when not measured
+};
+
+struct BenchmarkOptions {
+    std::string output = "benchmark.json";
+    std::string filter;                 ///< Only run benchmarks whose layer/name contains this
+    size_t threads = 0;
+    double minSeconds = 0.5;            ///< Minimum measured time per benchmark
+    bool quick = false;                 ///< Smaller sizes and shorter runs
+};
+
+static volatile double sink; ///< Keeps benchmarked results alive
+
+// Run fn in batches of doubling size until a batch lasts minSeconds, return seconds per call
+template <typename Function>
+static double measure(Function&& fn, double minSeconds, size_t& iterations) {
+    fn(); // Warm up caches, pools and lazily built tables
+
+    Utils::Stopwatch stopwatch;
+    for (iterations = 1;; iterations *= 2) {
+        stopwatch.restart();
+        for (size_t k = 0; k < iterations; k++) fn();
+        stopwatch.stop();
+
+        double elapsed = stopwatch.getElapsedTimeInSeconds();
+        if (elapsed >= minSeconds || iterations >= (size_t(1) << 30)) return elapsed / iterations;
+    }
+}
+
+// Central mass with an exponential disk of bodies on circular orbits, n bodies in all.
+// Drawn by Physics::Generators, so the same seed gives the same bodies on every machine and thread count.
+static Physics::BodyStorage generateDisk(size_t n, uint64_t seed, Physics::ThreadPool& pool) {
+    Physics::Generators::DiskOptions disk;
+    disk.count = n - 1;
+    disk.centralMass = 2.0e30;
+    disk.diskMass = 5.0e23 * double(n - 1);
+    disk.scaleLength = 5.0e10;
+    disk.dispersion = 0.0;
+    return Physics::Generators::disk(disk, seed, pool);
+}
+
+class BenchmarkSuite {
+    BenchmarkOptions options;
+    Physics::ThreadPool pool;
+    std::vector<BenchmarkResult> results;
+
+    bool selected(const std::string& layer, const std::string& name) const {
+        return options.filter.empty() || (layer + "/" + name).find(options.filter) != std::string::npos;
+    }
+
+    void report(const BenchmarkResult& result) {
+        std::cout << std::left << std::setw(9) << result.layer << std::setw(34) << result.name
+            << std::right << std::setw(8) << result.bodies << "  ";
+        if (result.layer == "math") std::cout << std::fixed << std::setprecision(3) << result.nsPerOperation << " ns/op";
+        if (result.layer == "kernel") std::cout << std::fixed << std::setprecision(3) << result.nsPerInteraction << " ns/interaction";
+        if (result.layer == "scenario") std::cout << std::fixed << std::setprecision(1) << result.stepsPerSecond << " steps/s";
+        if (result.maxRelativeError >= 0.0) std::cout << std::scientific << std::setprecision(2) << "  max error " << result.maxRelativeError;
+        std::cout << std::defaultfloat << std::endl;
+        results.push_back(result);
+    }
+
+    // Math layer: operations over a block of vectors
+    template <typename Function>
+    void mathBenchmark(const std::string& name, Function&& fn) {
+        if (!selected("math", name)) return;
+
+        static constexpr size_t Count = 4096;
+        std::vector<Math::Vector> a(Count), b(Count);
+        std::mt19937 engine(1);
+        std::uniform_real_distribution<double> value(-1.0e11, 1.0e11);
+        for (size_t i = 0; i < Count; i++) {
+            a[i] = Math::Vector(value(engine), value(engine));
+            b[i] = Math::Vector(value(engine), value(engine));
+        }
+
+        BenchmarkResult result;
+        result.layer = "math";
+        result.name = name;
+        result.secondsPerIteration = measure([&]() {
+            double total = 0.0;
+            for (size_t i = 0; i < Count; i++) total += fn(a[i], b[i]);
+            sink = total;
+        }, options.minSeconds, result.iterations);
+        result.nsPerOperation = result.secondsPerIteration * 1.0e9 / Count;
+        report(result);
+    }
+
+    void kernelBenchmark(const std::string& name, Physics::GravitySolver& solver, size_t n) {
+        if (!selected("kernel", name)) return;
+
+        Physics::BodyStorage storage = generateDisk(n, 7, pool);
+
+        BenchmarkResult result;
+        result.layer = "kernel";
+        result.name = name;
+        result.bodies = n;
+        result.secondsPerIteration = measure([&]() { solver.computeAccelerations(storage, pool); },
+            options.minSeconds, result.iterations);
+        result.nsPerInteraction = result.secondsPerIteration * 1.0e9 / (double(n) * double(n - 1));
+
+        // Accuracy of approximate solvers while the exact reference is affordable
+        if (n <= 20000 && name.rfind("direct", 0) != 0) {
+            Physics::DirectSolver reference;
+            result.maxRelativeError = Physics::SolverComparison::compare(reference, solver, storage, pool).maxRelativeError;
+        }
+        report(result);
+    }
+
+    void scenarioBenchmark(const std::string& name, Physics::World& world, double timeStep) {
+        if (!selected("scenario", name)) return;
+
+        BenchmarkResult result;
+        result.layer = "scenario";
+        result.name = name;
+        result.bodies = world.numBodies();
+        result.secondsPerIteration = measure([&]() { world.step(timeStep); }, options.minSeconds, result.iterations);
+        result.stepsPerSecond = 1.0 / result.secondsPerIteration;
+        report(result);
+    }
+
+public:
+    BenchmarkSuite(const BenchmarkOptions& options) : options(options), pool(options.threads) {}
+
+    void runMath() {
+        using Math::Vector;
+        using Math::Operation;
+
+        mathBenchmark("vector_add", [](const Vector& a, const Vector& b) { return (a + b).x; });
+        mathBenchmark("vector_subtract", [](const Vector& a, const Vector& b) { return (a - b).y; });
+        mathBenchmark("vector_scale", [](const Vector& a, const Vector& b) { return (a * b.x).x; });
+        mathBenchmark("vector_add_assign", [](const Vector& a, const Vector& b) { Vector c = a; c += b; return c.x; });
+        mathBenchmark("operation_dot", [](const Vector& a, const Vector& b) { return Operation::DotProduct(a, b); });
+        mathBenchmark("operation_length", [](const Vector& a, const Vector&) { return Operation::Length(a); });
+        mathBenchmark("operation_normalize", [](const Vector& a, const Vector&) { return Operation::Normalize(a).x; });
+        mathBenchmark("operation_distance", [](const Vector& a, const Vector& b) { return Operation::Distance(a, b); });
+    }
+
+    void runKernels() {
+        std::vector<size_t> sizes = { 10, 100, 1000, 10000, 100000 };
+        if (options.quick) sizes.pop_back();
+
+        for (size_t n : sizes) {
+            for (auto isa : { Physics::GravityKernel::Isa::Scalar, Physics::GravityKernel::Isa::AVX2, Physics::GravityKernel::Isa::AVX512 }) {
+                if (!Physics::GravityKernel::supported(isa)) continue;
+                Physics::DirectSolver direct;
+                direct.setKernel(isa);
+                std::string name = std::string("direct_") + Physics::GravityKernel::name(isa);
+                kernelBenchmark(name, direct, n);
+
+                // Float pairwise math, compared against the double direct solver
+                Physics::DirectSolver mixed;
+                mixed.setKernel(isa);
+                mixed.setPrecision(Physics::DirectSolver::Precision::Mixed);
+                kernelBenchmark(std::string("mixed_") + Physics::GravityKernel::name(isa), mixed, n);
+            }
+
+            Physics::DirectSolver symmetric;
+            symmetric.setSymmetric(true);
+            kernelBenchmark("direct_symmetric", symmetric, n);
+
+            Physics::BarnesHutSolver barnesHut;
+            kernelBenchmark("barnes_hut", barnesHut, n);
+
+            Physics::FastMultipoleSolver multipole;
+            kernelBenchmark("fast_multipole", multipole, n);
+
+            Physics::ParticleMeshSolver mesh;
+            kernelBenchmark("particle_mesh", mesh, n);
+        }
+    }
+
+    void runScenarios(const std::string& directory) {
+        // Every scenario file shipped with the repository
+        std::vector<std::filesystem::path> files;
+        if (std::filesystem::is_directory(directory)) {
+            for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+                if (entry.path().extension() == ".csv") files.push_back(entry.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        for (const auto& file : files) {
+            for (auto integrator : { Physics::World::Integrator::Leapfrog, Physics::World::Integrator::Yoshida4 }) {
+                Physics::World world;
+                world.setThreadCount(options.threads);
+                world.setIntegrator(integrator);
+                Physics::Scenario::load(file.string(), world);
+
+                std::string name = file.stem().string() + (integrator == Physics::World::Integrator::Leapfrog ? "_leapfrog" : "_yoshida4");
+                scenarioBenchmark(name, world, 1.0e4);
+            }
+        }
+
+        // Generated disks with the exact and the tree solver
+        std::vector<size_t> sizes = { 1000, 10000 };
+        if (!options.quick) sizes.push_back(100000);
+
+        for (size_t n : sizes) {
+            Physics::BodyStorage disk = generateDisk(n, 11, pool);
+
+            if (n <= 10000) {
+                Physics::World world;
+                world.setThreadCount(options.threads);
+                world.setIntegrator(Physics::World::Integrator::Leapfrog);
+                world.addBodies(disk);
+                scenarioBenchmark("disk_direct_leapfrog", world, 1.0e4);
+            }
+
+            Physics::World world;
+            world.setThreadCount(options.threads);
+            world.setIntegrator(Physics::World::Integrator::Leapfrog);
+            world.setSolver(std::make_shared<Physics::BarnesHutSolver>());
+            world.addBodies(disk);
+            scenarioBenchmark("disk_barnes_hut_leapfrog", world, 1.0e4);
+        }
+
+        // Generated Plummer clusters up to a million bodies, tree solver only
+        sizes = { 10000, 100000 };
+        if (!options.quick) sizes.push_back(1000000);
+
+        for (size_t n : sizes) {
+            Physics::World world;
+            world.setThreadCount(options.threads);
+            world.setIntegrator(Physics::World::Integrator::Leapfrog);
+            world.setSolver(std::make_shared<Physics::BarnesHutSolver>());
+
+            Physics::Generators::PlummerOptions plummer;
+            plummer.count = n;
+            Physics::Generators::plummer(world, plummer, 1);
+            scenarioBenchmark("plummer_barnes_hut_leapfrog", world, 1.0e9);
+        }
+    }
+
+    size_t size() const {
+        return results.size();
+    }
+
+    void write() const {
+        std::ofstream file(options.output);
+        if (!file.is_open()) {
+            throw std::runtime_error("Unable to write " + options.output);
+        }
+        file.precision(9);
+
+        const bool csv = std::filesystem::path(options.output).extension() == ".csv";
+        if (csv) {
+            file << "layer,name,bodies,iterations,seconds_per_iteration,ns_per_operation,ns_per_interaction,steps_per_second,max_relative_error\n";
+            for (const auto& r : results) {
+                file << r.layer << ',' << r.name << ',' << r.bodies << ',' << r.iterations << ','
+                    << r.secondsPerIteration << ',' << r.nsPerOperation << ',' << r.nsPerInteraction << ','
+                    << r.stepsPerSecond << ',' << r.maxRelativeError << '\n';
+            }
+            return;
+        }
+
+        file << "{\n";
+        file << "  \"threads\": " << pool.size() << ",\n";
+        file << "  \"kernel\": \"" << Physics::GravityKernel::name(Physics::GravityKernel::detect()) << "\",\n";
+        file << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchmarkResult& r = results[i];
+            file << "    {\"layer\": \"" << r.layer << "\", \"name\": \"" << r.name << "\", \"bodies\": " << r.bodies
+                << ", \"iterations\": " << r.iterations << ", \"seconds_per_iteration\": " << r.secondsPerIteration;
+            if (r.layer == "math") file << ", \"ns_per_operation\": " << r.nsPerOperation;
+            if (r.layer == "kernel") file << ", \"ns_per_interaction\": " << r.nsPerInteraction;
+            if (r.layer == "scenario") file << ", \"steps_per_second\": " << r.stepsPerSecond;
+            if (r.maxRelativeError >= 0.0) file << ", \"max_relative_error\": " << r.maxRelativeError;
+            file << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        file << "  ]\n}\n";
+    }
+};
+
+static void printUsage() {
+    std::cout <<
+        "Usage: Benchmark [options]\n"
+        "  --output FILE     Results file, .json or .csv (default benchmark.json)\n"
+        "  --layer NAME      math, kernel or scenario (default all)\n"
+        "  --filter TEXT     Only run benchmarks whose layer/name contains TEXT, e.g. kernel/barnes\n"
+        "  --threads N       Worker threads, 0 for all (default 0)\n"
+        "  --time S          Minimum measured seconds per benchmark (default 0.5)\n"
+        "  --quick           Skip the largest sizes and measure for 0.1 s\n";
+}
+
+int main(int argc, char** argv) {
+    try {
+        BenchmarkOptions options;
+        std::string layer;
+
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+                return argv[++i];
+            };
+
+            if (arg == "--output") options.output = value();
+            else if (arg == "--layer") layer = value();
+            else if (arg == "--filter") options.filter = value();
+            else if (arg == "--threads") options.threads = std::stoul(value());
+            else if (arg == "--time") options.minSeconds = std::stod(value());
+            else if (arg == "--quick") { options.quick = true; options.minSeconds = 0.1; }
+            else if (arg == "--help") { printUsage(); return 0; }
+            else throw std::invalid_argument("Unknown option " + arg);
+        }
+
+        if (!layer.empty() && layer != "math" && layer != "kernel" && layer != "scenario") {
+            throw std::invalid_argument("Unknown layer " + layer);
+        }
+
+        BenchmarkSuite suite(options);
+        if (layer.empty() || layer == "math") suite.runMath();
+        if (layer.empty() || layer == "kernel") suite.runKernels();
+        if (layer.empty() || layer == "scenario") suite.runScenarios("data/sims");
+        if (suite.size() == 0) {
+            throw std::runtime_error("No benchmark matched" + (options.filter.empty() ? std::string() : " --filter " + options.filter));
+        }
+        suite.write();
+
+        std::cout << "Results written to " << options.output << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
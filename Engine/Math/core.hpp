@@ -5,8 +5,11 @@
 #include "headers/Vector.hpp"
 #include "headers/Transformation.hpp"
 #include "headers/BoundingBox.hpp"
+#include "headers/AABBTree.hpp"
 #include "headers/Operation.hpp"
 #include "headers/Converter.hpp"
+#include "headers/FFT.hpp"
+#include "headers/Philox.hpp"
 #include "headers/Constants.hpp"
 
 
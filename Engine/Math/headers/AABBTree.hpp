@@ -0,0 +1,223 @@
+#ifndef AABB_TREE_HPP
+#define AABB_TREE_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+#include "BoundingBox.hpp"
+#include "Vector.hpp"
+
+namespace Math {
+
+    // Dynamic bounding volume hierarchy of axis aligned boxes.
+    //
+    // Every proxy is a leaf holding a "fat" box: its box grown by the margin, and in the
+    // direction of motion when a displacement is given. A proxy is only reinserted once its
+    // box leaves the fat box, so slowly moving objects rarely touch the tree. Insertion picks
+    // the sibling by the surface area heuristic, and AVL rotations on the way back up keep
+    // the tree balanced, so queries are O(log N + k).
+    //
+    // Nodes live in one pool with a free list. Queries walk the tree with a small stack on the
+    // caller's frame and report through a callback, so they never allocate.
+    class AABBTree {
+    public:
+        static constexpr int32_t Null = -1;
+
+    private:
+        struct Node {
+            BoundingBox box;        // Fat box for leaves, union of the children otherwise
+            int32_t parent = Null;  // Next free node while on the free list
+            int32_t child1 = Null;
+            int32_t child2 = Null;
+            int32_t height = 0;     // Leaves are 0, free nodes -1
+            uint32_t userData = 0;
+
+            bool isLeaf() const { return child1 == Null; }
+        };
+
+        // Traversal stack, Inline entries on the caller's frame before it spills to the heap.
+        // Balanced trees need about two entries per level.
+        template <typename T, size_t Inline>
+        class Stack {
+            T inlineData[Inline];
+            std::vector<T> overflow;
+            size_t count = 0;
+
+        public:
+            void push(const T& item) {
+                if (count < Inline) inlineData[count] = item;
+                else overflow.push_back(item);
+                count++;
+            }
+            T pop() {
+                count--;
+                if (count < Inline) return inlineData[count];
+                const T item = overflow.back();
+                overflow.pop_back();
+                return item;
+            }
+            bool empty() const { return count == 0; }
+        };
+        using NodeStack = Stack<int32_t, 64>;
+        using PairStack = Stack<std::pair<int32_t, int32_t>, 128>;
+
+        std::vector<Node> nodes;
+        int32_t root = Null;
+        int32_t freeList = Null;
+        size_t proxyCount = 0;
+        double margin;
+
+        int32_t allocateNode();
+        void freeNode(int32_t node);
+        void insertLeaf(int32_t leaf);
+        void removeLeaf(int32_t leaf);
+        int32_t balance(int32_t node);
+        void refitAncestors(int32_t node);     // Recompute boxes and heights up to the root, rotating as needed
+
+    public:
+        // Fat boxes are grown by margin on every side
+        explicit AABBTree(double margin = 0.0);
+
+        // Add a proxy for box and return its id, userData is handed back by queries
+        int32_t insert(const BoundingBox& box, uint32_t userData);
+        void remove(int32_t proxy);
+
+        // Update a proxy's box. Reinserts it only if the box left its fat box (or the fat box is
+        // far too large) and returns whether it did. The fat box is stretched along displacement.
+        bool move(int32_t proxy, const BoundingBox& box, const Vector& displacement = Vector(0.0, 0.0));
+
+        // Remove every proxy, keeping the node pool
+        void clear();
+
+        uint32_t getUserData(int32_t proxy) const;
+        const BoundingBox& getFatBox(int32_t proxy) const;
+        size_t getProxyCount() const;
+        int32_t getHeight() const;
+        double getMargin() const;
+
+        // Sum of internal node perimeters over the root's, lower is a tighter tree
+        double getAreaRatio() const;
+
+        // Throws std::logic_error if the structure, heights or boxes are inconsistent
+        void validate() const;
+
+        // Call callback(proxy) for every proxy whose fat box overlaps box.
+        // Return false from the callback to stop the query.
+        template <typename Callback>
+        void query(const BoundingBox& box, Callback&& callback) const {
+            NodeStack stack;
+            if (root != Null) stack.push(root);
+            while (!stack.empty()) {
+                const Node& node = nodes[stack.pop()];
+                if (!node.box.overlaps(box)) continue;
+                if (node.isLeaf()) {
+                    if (!callback(static_cast<int32_t>(&node - nodes.data()))) return;
+                }
+                else {
+                    stack.push(node.child1);
+                    stack.push(node.child2);
+                }
+            }
+        }
+
+        // Proxies whose fat box contains point
+        template <typename Callback>
+        void queryPoint(const Vector& point, Callback&& callback) const {
+            query(BoundingBox(point, point), callback);
+        }
+
+        // Proxies whose fat box meets the disc, pruned by distance rather than by the disc's box
+        template <typename Callback>
+        void queryRadius(const Vector& center, double radius, Callback&& callback) const {
+            NodeStack stack;
+            if (root != Null) stack.push(root);
+            while (!stack.empty()) {
+                const Node& node = nodes[stack.pop()];
+                if (!node.box.overlapsDisc(center, radius)) continue;
+                if (node.isLeaf()) {
+                    if (!callback(static_cast<int32_t>(&node - nodes.data()))) return;
+                }
+                else {
+                    stack.push(node.child1);
+                    stack.push(node.child2);
+                }
+            }
+        }
+
+        // Ray origin + t * direction for 0 <= t <= maxT. callback(proxy, t) is called for every
+        // proxy whose fat box the ray enters at t, nearer boxes first along each path, and
+        // returns the new maxT: its exact hit to keep only nearer ones, maxT to go on, 0 to stop.
+        template <typename Callback>
+        void raycast(const Vector& origin, const Vector& direction, double maxT, Callback&& callback) const {
+            const Vector inverse(1.0 / direction.x, 1.0 / direction.y);
+            NodeStack stack;
+            if (root != Null) stack.push(root);
+            while (!stack.empty()) {
+                const Node& node = nodes[stack.pop()];
+                double t;
+                if (!node.box.intersectsRay(origin, inverse, maxT, t)) continue;
+                if (node.isLeaf()) {
+                    maxT = callback(static_cast<int32_t>(&node - nodes.data()), t);
+                    if (!(maxT > 0.0)) return;
+                    continue;
+                }
+
+                // Visit the nearer child first so hits shrink maxT early
+                double t1 = std::numeric_limits<double>::infinity(), t2 = t1;
+                const bool hit1 = nodes[node.child1].box.intersectsRay(origin, inverse, maxT, t1);
+                const bool hit2 = nodes[node.child2].box.intersectsRay(origin, inverse, maxT, t2);
+                if (hit1 && hit2) {
+                    stack.push(t1 <= t2 ? node.child2 : node.child1);
+                    stack.push(t1 <= t2 ? node.child1 : node.child2);
+                }
+                else if (hit1) stack.push(node.child1);
+                else if (hit2) stack.push(node.child2);
+            }
+        }
+
+        // Call callback(a, b) once for every pair of proxies whose fat boxes overlap, a < b.
+        // Walks the tree against itself, so disjoint subtrees are rejected with one test.
+        template <typename Callback>
+        void queryPairs(Callback&& callback) const {
+            if (root == Null || nodes[root].isLeaf()) return;
+
+            // A pair (n, n) stands for the pairs within subtree n
+            PairStack stack;
+            stack.push({ root, root });
+            while (!stack.empty()) {
+                const auto [a, b] = stack.pop();
+                const Node& A = nodes[a];
+                const Node& B = nodes[b];
+
+                if (a == b) {
+                    if (A.isLeaf()) continue;
+                    stack.push({ A.child1, A.child1 });
+                    stack.push({ A.child2, A.child2 });
+                    stack.push({ A.child1, A.child2 });
+                    continue;
+                }
+
+                if (!A.box.overlaps(B.box)) continue;
+                if (A.isLeaf() && B.isLeaf()) {
+                    callback(std::min(a, b), std::max(a, b));
+                }
+                else if (B.isLeaf() || (!A.isLeaf() && A.height >= B.height)) {
+                    // Split the taller subtree
+                    stack.push({ A.child1, b });
+                    stack.push({ A.child2, b });
+                }
+                else {
+                    stack.push({ a, B.child1 });
+                    stack.push({ a, B.child2 });
+                }
+            }
+        }
+    };
+
+} // namespace Math
+
+#endif // AABB_TREE_HPP
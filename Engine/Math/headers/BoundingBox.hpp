@@ -1,26 +1,111 @@
 #ifndef BOUNDING_BOX_HPP
 #define BOUNDING_BOX_HPP
 
-namespace Math {
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "Vector.hpp"
 
-    // Forward Declaration of Vector
-    struct Vector;
+namespace Math {
 
-    // Axis Aligned Bounding Box
+    // Axis Aligned Bounding Box, a plain value. The default box is empty:
+    // it contains nothing and expanding it by anything gives that thing's box.
     struct BoundingBox {
-        Vector* min;
-        Vector* max;
+        Vector min;
+        Vector max;
 
-        BoundingBox(Vector* min, Vector* max);
+        BoundingBox()
+            : min(std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()),
+              max(-std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()) {}
 
-        BoundingBox(double minX, double minY, double maxX, double maxY);
+        BoundingBox(const Vector& min, const Vector& max) : min(min), max(max) {}
 
-        ~BoundingBox();
+        BoundingBox(double minX, double minY, double maxX, double maxY) : min(minX, minY), max(maxX, maxY) {}
 
-    };
+        // Box around a disc
+        static BoundingBox Around(const Vector& center, double radius) {
+            return BoundingBox(center.x - radius, center.y - radius, center.x + radius, center.y + radius);
+        }
+
+        bool isEmpty() const { return min.x > max.x || min.y > max.y; }
+
+        double width() const { return max.x - min.x; }
+        double height() const { return max.y - min.y; }
+        double area() const { return width() * height(); }
+        double perimeter() const { return 2.0 * (width() + height()); }
+        Vector center() const { return Vector(0.5 * (min.x + max.x), 0.5 * (min.y + max.y)); }
+
+        bool contains(const Vector& point) const {
+            return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y;
+        }
+
+        bool contains(const BoundingBox& other) const {
+            return other.min.x >= min.x && other.max.x <= max.x && other.min.y >= min.y && other.max.y <= max.y;
+        }
+
+        // Touching boxes overlap
+        bool overlaps(const BoundingBox& other) const {
+            return other.min.x <= max.x && other.max.x >= min.x && other.min.y <= max.y && other.max.y >= min.y;
+        }
 
+        // Squared distance from a point to the box, 0 inside
+        double distanceSquared(const Vector& point) const {
+            const double dx = std::max({ min.x - point.x, 0.0, point.x - max.x });
+            const double dy = std::max({ min.y - point.y, 0.0, point.y - max.y });
+            return dx * dx + dy * dy;
+        }
+
+        bool overlapsDisc(const Vector& center, double radius) const {
+            return distanceSquared(center) <= radius * radius;
+        }
+
+        // Slab test of the ray origin + t * direction, 0 <= t <= maxT, given 1 / direction per axis
+        // (infinite for axis-parallel rays). Sets t to the entry parameter on a hit.
+        bool intersectsRay(const Vector& origin, const Vector& inverseDirection, double maxT, double& t) const {
+            double t0 = 0.0, t1 = maxT;
+            clipSlab(min.x, max.x, origin.x, inverseDirection.x, t0, t1);
+            clipSlab(min.y, max.y, origin.y, inverseDirection.y, t0, t1);
+            if (t0 > t1) return false;
+            t = t0;
+            return true;
+        }
+
+        // Grow to include a point or a box
+        void expand(const Vector& point) {
+            min.x = std::min(min.x, point.x); min.y = std::min(min.y, point.y);
+            max.x = std::max(max.x, point.x); max.y = std::max(max.y, point.y);
+        }
+
+        void expand(const BoundingBox& other) {
+            min.x = std::min(min.x, other.min.x); min.y = std::min(min.y, other.min.y);
+            max.x = std::max(max.x, other.max.x); max.y = std::max(max.y, other.max.y);
+        }
+
+        // Smallest box containing both
+        static BoundingBox Merge(const BoundingBox& a, const BoundingBox& b) {
+            BoundingBox box = a;
+            box.expand(b);
+            return box;
+        }
+
+        // Box grown by margin on every side
+        BoundingBox inflated(double margin) const {
+            return BoundingBox(min.x - margin, min.y - margin, max.x + margin, max.y + margin);
+        }
+
+    private:
+        // Narrow [t0, t1] to the ray parameters inside one slab. An origin on the slab's face
+        // with a parallel ray gives 0 * infinity = NaN, which fails both tests and clips nothing.
+        static void clipSlab(double low, double high, double origin, double inverse, double& t0, double& t1) {
+            double enter = (low - origin) * inverse, leave = (high - origin) * inverse;
+            if (enter > leave) std::swap(enter, leave);
+            if (enter > t0) t0 = enter;
+            if (leave < t1) t1 = leave;
+        }
+    };
 
 } // namespace Math
 
 
-#endif // BOUNDING_BOX_HPP
\ No newline at end of file
+#endif // BOUNDING_BOX_HPP
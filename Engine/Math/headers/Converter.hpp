@@ -9,7 +9,7 @@ namespace Math {
 
     class Converter {
     private:
-        static double scale; // Scale factor for conversions
+        static inline double scale = 1.0; // Scale factor for conversions
 
     public:
         // Set the scale factor
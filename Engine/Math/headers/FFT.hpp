@@ -0,0 +1,39 @@
+#ifndef FFT_HPP
+#define FFT_HPP
+
+#include <vector>
+#include <complex>
+#include <cstddef>
+
+namespace Math {
+
+    // Radix-2 complex Fast Fourier Transform of a fixed power of two length.
+    // Twiddle factors and the bit reversal permutation are computed once.
+    class FFT {
+    public:
+        using Complex = std::complex<double>;
+
+    private:
+        size_t n;
+        std::vector<Complex> twiddles;      // exp(-2 pi i k / n) for k < n / 2
+        std::vector<size_t> reversal;       // Bit reversed index of every position
+
+        void transform(Complex* data, bool inverse) const;
+
+    public:
+        explicit FFT(size_t n);
+
+        size_t size() const;
+
+        // In-place forward transform, X_k = sum x_j exp(-2 pi i jk / n)
+        void forward(Complex* data) const;
+
+        // In-place inverse transform, scaled by 1 / n
+        void inverse(Complex* data) const;
+
+        static bool isPowerOfTwo(size_t n);
+    };
+
+} // namespace Math
+
+#endif // FFT_HPP
@@ -22,34 +22,42 @@ namespace Math {
     public:
 
         // Dot Product
-        static inline double DotProduct(const Vector& v1, const Vector& v2) {
-            return v1.x * v2.x + v1.y * v2.y;
+        template <typename T, size_t Dim>
+        static constexpr T DotProduct(const BasicVector<T, Dim>& v1, const BasicVector<T, Dim>& v2) {
+            if constexpr (Dim == 2) return v1.x * v2.x + v1.y * v2.y;
+            else return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
         }
 
-        // Cross Product
-        static inline double CrossProduct(const Vector& v1, const Vector& v2) {
-            return v1.x * v2.y - v1.y * v2.x;
+        // Cross Product, a scalar in 2D and a vector in 3D
+        template <typename T, size_t Dim>
+        static constexpr auto CrossProduct(const BasicVector<T, Dim>& v1, const BasicVector<T, Dim>& v2) {
+            if constexpr (Dim == 2) return v1.x * v2.y - v1.y * v2.x;
+            else return BasicVector<T, 3>(v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x);
         }
 
         // Lenght of a vector
-        static inline double Length(const Vector& v) {
-            return sqrt(v.x * v.x + v.y * v.y);
+        template <typename T, size_t Dim>
+        static inline T Length(const BasicVector<T, Dim>& v) {
+            return std::sqrt(DotProduct(v, v));
         }
 
         // Normalize a vector
-        static inline Vector Normalize(const Vector& v) {
-            double len = Length(v);
-            return Vector(v.x / len, v.y / len);
+        template <typename T, size_t Dim>
+        static inline BasicVector<T, Dim> Normalize(const BasicVector<T, Dim>& v) {
+            return v / Length(v);
         }
 
         // Distance between two points
-        static inline double Distance(const Vector& v1, const Vector& v2) {
+        template <typename T, size_t Dim>
+        static inline T Distance(const BasicVector<T, Dim>& v1, const BasicVector<T, Dim>& v2) {
             return Length(v1 - v2);
         }
 
         // Squared Distance between two points
-        static inline double SquaredDistance(const Vector& v1, const Vector& v2) {
-            return (v1.x - v2.x) * (v1.x - v2.x) + (v1.y - v2.y) * (v1.y - v2.y);
+        template <typename T, size_t Dim>
+        static constexpr T SquaredDistance(const BasicVector<T, Dim>& v1, const BasicVector<T, Dim>& v2) {
+            const BasicVector<T, Dim> d = v1 - v2;
+            return DotProduct(d, d);
         }
 
         // Clamp
@@ -60,10 +68,17 @@ namespace Math {
             return value;
         }
 
-        static Vector ArtimeticMean(const std::vector<Vector>& vertices);
+        // Mean of the vertices
+        template <typename T, size_t Dim>
+        static inline BasicVector<T, Dim> ArtimeticMean(const std::vector<BasicVector<T, Dim>>& vertices) {
+            BasicVector<T, Dim> sum;
+            for (const BasicVector<T, Dim>& vertex : vertices) sum += vertex;
+            return sum / static_cast<T>(vertices.size());
+        }
 
         // Edge between two points
-        static inline Vector EdgeBetween(const Vector& p1, const Vector& p2) {
+        template <typename T, size_t Dim>
+        static constexpr BasicVector<T, Dim> EdgeBetween(const BasicVector<T, Dim>& p1, const BasicVector<T, Dim>& p2) {
             /*
                 Edge from point 1 to point 2:
                 Edge = Point 2 - Point 1
@@ -90,13 +105,15 @@ namespace Math {
         }
 
         // Check if two vectors are nearly equal
-        static inline bool NearlyEqual(const Vector& v1, const Vector& v2, double epsilon) {
+        template <typename T, size_t Dim>
+        static constexpr bool NearlyEqual(const BasicVector<T, Dim>& v1, const BasicVector<T, Dim>& v2, typename BasicVector<T, Dim>::Scalar epsilon) {
             return SquaredDistance(v1, v2) < epsilon * epsilon;
         }
 
         // Get the perpendicular vector
-        static inline Vector Perpendicular(const Vector& v) {
-            return Vector(-v.y, v.x);
+        template <typename T>
+        static constexpr BasicVector<T, 2> Perpendicular(const BasicVector<T, 2>& v) {
+            return BasicVector<T, 2>(-v.y, v.x);
         }
 
     };
@@ -0,0 +1,105 @@
+#ifndef PHILOX_HPP
+#define PHILOX_HPP
+
+#include <array>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+
+#include "Constants.hpp"
+
+namespace Math {
+
+    // Counter-based Philox4x32-10 random number generator (Salmon et al., "Parallel
+    // Random Numbers: As Easy as 1, 2, 3", 2011).
+    //
+    // Each output block is a pure function of (counter, key), so any number of
+    // independent streams can be drawn in parallel without shared state. A generator
+    // for (seed, stream) always produces the same sequence, whichever thread runs it
+    // and in whatever order the streams are visited.
+    class Philox {
+    public:
+        using Block = std::array<uint32_t, 4>;
+        using result_type = uint32_t;
+
+    private:
+        uint64_t key;
+        uint64_t stream;
+        uint64_t counter = 0;   // Index of the next block
+        Block block{};
+        unsigned used = 4;      // Words of block already returned
+
+        static constexpr uint32_t Multiplier0 = 0xD2511F53u;
+        static constexpr uint32_t Multiplier1 = 0xCD9E8D57u;
+        static constexpr uint32_t Weyl0 = 0x9E3779B9u;     // Golden ratio
+        static constexpr uint32_t Weyl1 = 0xBB67AE85u;     // sqrt(3) - 1
+
+    public:
+        // Stream selects one of 2^64 independent sequences for the seed
+        explicit Philox(uint64_t seed, uint64_t stream = 0) : key(seed), stream(stream) {}
+
+        // Ten Philox rounds of counter under key
+        static Block generate(Block counter, uint64_t key) {
+            uint32_t k0 = static_cast<uint32_t>(key);
+            uint32_t k1 = static_cast<uint32_t>(key >> 32);
+
+            for (int round = 0; round < 10; round++) {
+                const uint64_t product0 = uint64_t(Multiplier0) * counter[0];
+                const uint64_t product1 = uint64_t(Multiplier1) * counter[2];
+                counter = {
+                    static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ k0,
+                    static_cast<uint32_t>(product1),
+                    static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ k1,
+                    static_cast<uint32_t>(product0)
+                };
+                k0 += Weyl0;
+                k1 += Weyl1;
+            }
+            return counter;
+        }
+
+        // Next 32 random bits, satisfies UniformRandomBitGenerator
+        uint32_t operator()() {
+            if (used == 4) {
+                block = generate({ static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32),
+                    static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32) }, key);
+                counter++;
+                used = 0;
+            }
+            return block[used++];
+        }
+
+        static constexpr uint32_t min() { return 0; }
+        static constexpr uint32_t max() { return std::numeric_limits<uint32_t>::max(); }
+
+        uint64_t nextU64() {
+            const uint64_t low = (*this)();
+            return (uint64_t((*this)()) << 32) | low;
+        }
+
+        // Uniform in [0, 1) with 53 random bits
+        double uniform() {
+            return double(nextU64() >> 11) * 0x1.0p-53;
+        }
+
+        // Uniform in [min, max)
+        double uniform(double min, double max) {
+            return min + (max - min) * uniform();
+        }
+
+        // Standard normal deviate (Box-Muller, one value per call so draws stay in step)
+        double normal() {
+            const double u = 1.0 - uniform();   // (0, 1], safe for log
+            const double angle = Constants::TAU * uniform();
+            return std::sqrt(-2.0 * std::log(u)) * std::cos(angle);
+        }
+
+        // Exponential deviate with unit mean
+        double exponential() {
+            return -std::log(1.0 - uniform());
+        }
+    };
+
+} // namespace Math
+
+#endif // PHILOX_HPP
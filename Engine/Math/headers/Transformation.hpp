@@ -1,10 +1,9 @@
 #ifndef TRANSFORMATION_HPP
 #define TRANSFORMATION_HPP
 
-namespace Math {
+#include "Vector.hpp"
 
-    // Forward Declaration of FlatVector
-    struct Vector;
+namespace Math {
 
     struct Transformation {
         const double PositionX;
@@ -20,6 +19,16 @@ namespace Math {
         Transformation(double x, double y, double angle);
     };
 
+    // Rotate, then translate
+    template <typename T, size_t Dim>
+    BasicVector<T, Dim> BasicVector<T, Dim>::Transform(const BasicVector& vector, const Transformation& transform) {
+        static_assert(Dim == 2, "Transformations are 2D");
+        return BasicVector(
+            static_cast<T>(vector.x * transform.cosine - vector.y * transform.sine + transform.PositionX),
+            static_cast<T>(vector.x * transform.sine + vector.y * transform.cosine + transform.PositionY)
+        );
+    }
+
 
 
 } // namespace Math
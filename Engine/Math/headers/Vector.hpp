@@ -1,7 +1,8 @@
 #ifndef VECTOR_HPP
 #define VECTOR_HPP
 
-#include <iostream>
+#include <cstddef>
+#include <functional>
 #include <string>
 
 namespace Math {
@@ -9,41 +10,114 @@ namespace Math {
     // Forward Declaration of Transformation
     struct Transformation;
 
-    struct Vector {
-        double x, y;
+    // Named components of a vector, x and y in 2D, x, y and z in 3D
+    template <typename T, size_t Dim>
+    struct VectorComponents;
+
+    template <typename T>
+    struct VectorComponents<T, 2> {
+        T x, y;
+
+        constexpr VectorComponents(T x = T(0), T y = T(0)) : x(x), y(y) {}
+    };
+
+    template <typename T>
+    struct VectorComponents<T, 3> {
+        T x, y, z;
+
+        constexpr VectorComponents(T x = T(0), T y = T(0), T z = T(0)) : x(x), y(y), z(z) {}
+    };
+
+    // Vector of Dim components of type T. Everything is inline and constexpr, so the
+    // operators compile down to plain arithmetic in the loops that use them.
+    template <typename T, size_t Dim>
+    struct BasicVector : VectorComponents<T, Dim> {
+        static_assert(Dim == 2 || Dim == 3, "Vectors are 2D or 3D");
+
+        using Scalar = T;
+        static constexpr size_t Dimension = Dim;
+
+        using VectorComponents<T, Dim>::VectorComponents;
+
+        // Conversion between precisions, e.g. double simulation vectors to float render vectors
+        template <typename U>
+        explicit constexpr BasicVector(const BasicVector<U, Dim>& other) {
+            for (size_t i = 0; i < Dim; i++) (*this)[i] = static_cast<T>(other[i]);
+        }
 
         // Define zero vector
-        static Vector Zero;
+        static const BasicVector Zero;
 
-        Vector(double x = 0.0f, double y = 0.0f);
+        constexpr T& operator[](size_t i) {
+            if constexpr (Dim == 3) { if (i == 2) return this->z; }
+            return i == 0 ? this->x : this->y;
+        }
 
+        constexpr const T& operator[](size_t i) const {
+            if constexpr (Dim == 3) { if (i == 2) return this->z; }
+            return i == 0 ? this->x : this->y;
+        }
 
-        Vector operator+(const Vector& other) const; // Addition
-        Vector operator-(const Vector& other) const; // Subtraction
-        Vector operator*(double scalar) const; // Multiplication
-        Vector operator/(double scalar) const; // Division
+        constexpr BasicVector operator+(const BasicVector& other) const { return Map(*this, other, [](T a, T b) { return a + b; }); } // Addition
+        constexpr BasicVector operator-(const BasicVector& other) const { return Map(*this, other, [](T a, T b) { return a - b; }); } // Subtraction
+        constexpr BasicVector operator*(T scalar) const { return Map(*this, *this, [scalar](T a, T) { return a * scalar; }); } // Multiplication
+        constexpr BasicVector operator/(T scalar) const { return Map(*this, *this, [scalar](T a, T) { return a / scalar; }); } // Division
 
-        friend Vector operator*(double scalar, const Vector& vector); // Multiplication
+        // Multiplication
+        friend constexpr BasicVector operator*(T scalar, const BasicVector& vector) { return vector * scalar; }
 
-        Vector& operator+=(const Vector& other); // In-place addition
-        Vector& operator-=(const Vector& other); // In-place subtraction
-        Vector& operator*=(double scalar); // In-place multiplication
-        Vector& operator/=(double scalar); // In-place division
+        constexpr BasicVector& operator+=(const BasicVector& other) { return *this = *this + other; } // In-place addition
+        constexpr BasicVector& operator-=(const BasicVector& other) { return *this = *this - other; } // In-place subtraction
+        constexpr BasicVector& operator*=(T scalar) { return *this = *this * scalar; } // In-place multiplication
+        constexpr BasicVector& operator/=(T scalar) { return *this = *this / scalar; } // In-place division
 
-        Vector operator-() const; // Negation
-        bool operator==(const Vector& other) const; // Check for equality
-        std::string toString() const; // To string
+        constexpr BasicVector operator-() const { return Map(*this, *this, [](T a, T) { return -a; }); } // Negation
 
-        // Static function to transform a vector
-        static Vector Transform(const Vector& vector, Transformation& transform);
+        // Check for equality
+        constexpr bool operator==(const BasicVector& other) const {
+            for (size_t i = 0; i < Dim; i++) {
+                if ((*this)[i] != other[i]) return false;
+            }
+            return true;
+        }
 
-        // hash function
-        size_t hash() const;
+        constexpr bool operator!=(const BasicVector& other) const { return !(*this == other); }
+
+        // To string
+        std::string toString() const {
+            std::string text = "(";
+            for (size_t i = 0; i < Dim; i++) text += (i > 0 ? ", " : "") + std::to_string((*this)[i]);
+            return text + ")";
+        }
 
+        // Static function to transform a 2D vector, defined in Transformation.hpp
+        static BasicVector Transform(const BasicVector& vector, const Transformation& transform);
 
+        // hash function
+        size_t hash() const {
+            size_t h = 0;
+            for (size_t i = 0; i < Dim; i++) h ^= std::hash<T>()((*this)[i]);
+            return h;
+        }
+
+    private:
+        // Apply f component-wise, written out so it inlines without a loop
+        template <typename Function>
+        static constexpr BasicVector Map(const BasicVector& a, const BasicVector& b, Function f) {
+            if constexpr (Dim == 2) return BasicVector(f(a.x, b.x), f(a.y, b.y));
+            else return BasicVector(f(a.x, b.x), f(a.y, b.y), f(a.z, b.z));
+        }
     };
 
+    template <typename T, size_t Dim>
+    constexpr BasicVector<T, Dim> BasicVector<T, Dim>::Zero = BasicVector<T, Dim>();
+
+    using Vector = BasicVector<double, 2>;      // Simulation vectors
+    using Vector2f = BasicVector<float, 2>;     // Render side vectors
+    using Vector3 = BasicVector<double, 3>;
+    using Vector3f = BasicVector<float, 3>;
+
 } // namespace Math
 
 
-#endif // VECTOR_HPP
\ No newline at end of file
+#endif // VECTOR_HPP
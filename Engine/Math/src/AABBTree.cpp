@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "../headers/AABBTree.hpp"
+
+namespace Math {
+
+    // A fat box larger than the box grown by this many margins is shrunk on the next move
+    static constexpr double OversizeMargins = 4.0;
+
+    AABBTree::AABBTree(double margin) : margin(margin) {
+        if (!(margin >= 0.0)) {
+            throw std::invalid_argument("AABB tree margin must not be negative");
+        }
+    }
+
+    int32_t AABBTree::allocateNode() {
+        int32_t node;
+        if (freeList != Null) {
+            node = freeList;
+            freeList = nodes[node].parent;
+            nodes[node] = Node();
+        }
+        else {
+            node = static_cast<int32_t>(nodes.size());
+            nodes.emplace_back();
+        }
+        return node;
+    }
+
+    void AABBTree::freeNode(int32_t node) {
+        nodes[node].parent = freeList;
+        nodes[node].child1 = Null;
+        nodes[node].child2 = Null;
+        nodes[node].height = -1;
+        freeList = node;
+    }
+
+    int32_t AABBTree::insert(const BoundingBox& box, uint32_t userData) {
+        const int32_t proxy = allocateNode();
+        nodes[proxy].box = box.inflated(margin);
+        nodes[proxy].userData = userData;
+        insertLeaf(proxy);
+        proxyCount++;
+        return proxy;
+    }
+
+    void AABBTree::remove(int32_t proxy) {
+        if (proxy < 0 || proxy >= static_cast<int32_t>(nodes.size()) || nodes[proxy].height != 0) {
+            throw std::out_of_range("Invalid AABB tree proxy");
+        }
+        removeLeaf(proxy);
+        freeNode(proxy);
+        proxyCount--;
+    }
+
+    bool AABBTree::move(int32_t proxy, const BoundingBox& box, const Vector& displacement) {
+        if (proxy < 0 || proxy >= static_cast<int32_t>(nodes.size()) || nodes[proxy].height != 0) {
+            throw std::out_of_range("Invalid AABB tree proxy");
+        }
+
+        // Grow by the margin, then stretch along the motion expected before the next update
+        BoundingBox fat = box.inflated(margin);
+        if (displacement.x < 0.0) fat.min.x += displacement.x; else fat.max.x += displacement.x;
+        if (displacement.y < 0.0) fat.min.y += displacement.y; else fat.max.y += displacement.y;
+
+        const BoundingBox& current = nodes[proxy].box;
+        if (current.contains(box) && fat.inflated(OversizeMargins * margin).contains(current)) {
+            return false;
+        }
+
+        removeLeaf(proxy);
+        nodes[proxy].box = fat;
+        insertLeaf(proxy);
+        return true;
+    }
+
+    void AABBTree::clear() {
+        nodes.clear();
+        root = Null;
+        freeList = Null;
+        proxyCount = 0;
+    }
+
+    void AABBTree::insertLeaf(int32_t leaf) {
+        if (root == Null) {
+            root = leaf;
+            nodes[leaf].parent = Null;
+            return;
+        }
+
+        // Descend towards the sibling that adds the least perimeter to the tree. Making a new
+        // parent here costs the combined box; going deeper costs the growth of this node
+        // (inherited by every ancestor below it) plus the cost in the cheaper child.
+        const BoundingBox leafBox = nodes[leaf].box;
+        int32_t index = root;
+        while (!nodes[index].isLeaf()) {
+            const Node& node = nodes[index];
+            const double perimeter = node.box.perimeter();
+            const double combined = BoundingBox::Merge(node.box, leafBox).perimeter();
+
+            const double cost = 2.0 * combined;
+            const double inheritance = 2.0 * (combined - perimeter);
+
+            auto descendCost = [&](int32_t child) {
+                const double merged = BoundingBox::Merge(leafBox, nodes[child].box).perimeter();
+                if (nodes[child].isLeaf()) return merged + inheritance;
+                return merged - nodes[child].box.perimeter() + inheritance;
+            };
+            const double cost1 = descendCost(node.child1);
+            const double cost2 = descendCost(node.child2);
+
+            if (cost < cost1 && cost < cost2) break;
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+        const int32_t sibling = index;
+
+        // Join the leaf and its sibling under a new parent
+        const int32_t oldParent = nodes[sibling].parent;
+        const int32_t newParent = allocateNode();
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].box = BoundingBox::Merge(leafBox, nodes[sibling].box);
+        nodes[newParent].height = nodes[sibling].height + 1;
+        nodes[newParent].child1 = sibling;
+        nodes[newParent].child2 = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+
+        if (oldParent == Null) {
+            root = newParent;
+        }
+        else if (nodes[oldParent].child1 == sibling) {
+            nodes[oldParent].child1 = newParent;
+        }
+        else {
+            nodes[oldParent].child2 = newParent;
+        }
+
+        refitAncestors(nodes[leaf].parent);
+    }
+
+    void AABBTree::removeLeaf(int32_t leaf) {
+        if (leaf == root) {
+            root = Null;
+            return;
+        }
+
+        // The parent goes, the sibling takes its place
+        const int32_t parent = nodes[leaf].parent;
+        const int32_t grandParent = nodes[parent].parent;
+        const int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+        if (grandParent == Null) {
+            root = sibling;
+            nodes[sibling].parent = Null;
+            freeNode(parent);
+            return;
+        }
+
+        if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+        else nodes[grandParent].child2 = sibling;
+        nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        refitAncestors(grandParent);
+    }
+
+    void AABBTree::refitAncestors(int32_t node) {
+        while (node != Null) {
+            node = balance(node);
+
+            Node& current = nodes[node];
+            const Node& child1 = nodes[current.child1];
+            const Node& child2 = nodes[current.child2];
+            current.height = 1 + std::max(child1.height, child2.height);
+            current.box = BoundingBox::Merge(child1.box, child2.box);
+
+            node = current.parent;
+        }
+    }
+
+    // If one child of a is two levels taller than the other, rotate that child up into a's
+    // place and return its index, otherwise return a. The risen child keeps its taller child
+    // and hands the shorter one to a, which becomes its other child.
+    int32_t AABBTree::balance(int32_t a) {
+        Node& A = nodes[a];
+        if (A.isLeaf() || A.height < 2) return a;
+
+        const int32_t b = A.child1;
+        const int32_t c = A.child2;
+        const int32_t heightDifference = nodes[c].height - nodes[b].height;
+
+        auto rotateUp = [&](int32_t up, int32_t other) {
+            Node& U = nodes[up];
+            const int32_t f = U.child1;
+            const int32_t g = U.child2;
+            Node& F = nodes[f];
+            Node& G = nodes[g];
+
+            // up takes a's place
+            U.child1 = a;
+            U.parent = A.parent;
+            A.parent = up;
+            if (U.parent == Null) root = up;
+            else if (nodes[U.parent].child1 == a) nodes[U.parent].child1 = up;
+            else nodes[U.parent].child2 = up;
+
+            // The taller grandchild stays with up, the shorter moves under a
+            const bool keepF = F.height > G.height;
+            const int32_t kept = keepF ? f : g;
+            const int32_t moved = keepF ? g : f;
+            U.child2 = kept;
+            if (A.child1 == up) A.child1 = moved; else A.child2 = moved;
+            nodes[moved].parent = a;
+
+            const Node& O = nodes[other];
+            A.box = BoundingBox::Merge(O.box, nodes[moved].box);
+            U.box = BoundingBox::Merge(A.box, nodes[kept].box);
+            A.height = 1 + std::max(O.height, nodes[moved].height);
+            U.height = 1 + std::max(A.height, nodes[kept].height);
+            return up;
+        };
+
+        if (heightDifference > 1) return rotateUp(c, b);
+        if (heightDifference < -1) return rotateUp(b, c);
+        return a;
+    }
+
+    uint32_t AABBTree::getUserData(int32_t proxy) const {
+        if (proxy < 0 || proxy >= static_cast<int32_t>(nodes.size()) || nodes[proxy].height != 0) {
+            throw std::out_of_range("Invalid AABB tree proxy");
+        }
+        return nodes[proxy].userData;
+    }
+
+    const BoundingBox& AABBTree::getFatBox(int32_t proxy) const {
+        if (proxy < 0 || proxy >= static_cast<int32_t>(nodes.size()) || nodes[proxy].height != 0) {
+            throw std::out_of_range("Invalid AABB tree proxy");
+        }
+        return nodes[proxy].box;
+    }
+
+    size_t AABBTree::getProxyCount() const {
+        return proxyCount;
+    }
+
+    int32_t AABBTree::getHeight() const {
+        return root == Null ? 0 : nodes[root].height;
+    }
+
+    double AABBTree::getMargin() const {
+        return margin;
+    }
+
+    double AABBTree::getAreaRatio() const {
+        if (root == Null) return 0.0;
+        const double rootPerimeter = nodes[root].box.perimeter();
+        if (rootPerimeter <= 0.0) return 0.0;
+
+        double total = 0.0;
+        for (const Node& node : nodes) {
+            if (node.height > 0) total += node.box.perimeter();
+        }
+        return total / rootPerimeter;
+    }
+
+    void AABBTree::validate() const {
+        size_t leaves = 0, reached = 0;
+        if (root != Null) {
+            if (nodes[root].parent != Null) throw std::logic_error("AABB tree root has a parent");
+
+            std::vector<int32_t> stack{ root };
+            while (!stack.empty()) {
+                const int32_t index = stack.back();
+                stack.pop_back();
+                reached++;
+
+                const Node& node = nodes[index];
+                if (node.isLeaf()) {
+                    if (node.height != 0 || node.child2 != Null) throw std::logic_error("AABB tree leaf is malformed");
+                    leaves++;
+                    continue;
+                }
+
+                const Node& child1 = nodes[node.child1];
+                const Node& child2 = nodes[node.child2];
+                if (child1.parent != index || child2.parent != index) {
+                    throw std::logic_error("AABB tree child does not point to its parent");
+                }
+                if (node.height != 1 + std::max(child1.height, child2.height)) {
+                    throw std::logic_error("AABB tree node height is wrong");
+                }
+                const BoundingBox merged = BoundingBox::Merge(child1.box, child2.box);
+                if (merged.min.x != node.box.min.x || merged.min.y != node.box.min.y ||
+                    merged.max.x != node.box.max.x || merged.max.y != node.box.max.y) {
+                    throw std::logic_error("AABB tree node box does not fit its children");
+                }
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+
+        size_t free = 0;
+        for (int32_t index = freeList; index != Null; index = nodes[index].parent) free++;
+
+        if (leaves != proxyCount) throw std::logic_error("AABB tree proxy count is wrong");
+        if (reached + free != nodes.size()) throw std::logic_error("AABB tree loses nodes");
+    }
+
+} // namespace Math
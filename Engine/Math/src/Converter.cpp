@@ -1,6 +0,0 @@
-#include "../headers/Converter.hpp"
-#include "../headers/Vector.hpp"
-
-
-// Initialize the static scale variable
-double Math::Converter::scale = 1.0f; // Default scale factor
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "../headers/FFT.hpp"
+#include "../headers/Constants.hpp"
+
+namespace Math {
+
+    bool FFT::isPowerOfTwo(size_t n) {
+        return n > 0 && (n & (n - 1)) == 0;
+    }
+
+    FFT::FFT(size_t n) : n(n) {
+        if (!isPowerOfTwo(n)) {
+            throw std::invalid_argument("FFT length must be a power of two");
+        }
+
+        twiddles.resize(n / 2);
+        for (size_t k = 0; k < n / 2; k++) {
+            double angle = -Constants::TAU * static_cast<double>(k) / static_cast<double>(n);
+            twiddles[k] = Complex(std::cos(angle), std::sin(angle));
+        }
+
+        reversal.resize(n);
+        size_t bits = 0;
+        while ((size_t(1) << bits) < n) bits++;
+        for (size_t i = 0; i < n; i++) {
+            size_t r = 0;
+            for (size_t b = 0; b < bits; b++) {
+                if (i & (size_t(1) << b)) r |= size_t(1) << (bits - 1 - b);
+            }
+            reversal[i] = r;
+        }
+    }
+
+    size_t FFT::size() const {
+        return n;
+    }
+
+    void FFT::transform(Complex* data, bool inverse) const {
+        for (size_t i = 0; i < n; i++) {
+            if (i < reversal[i]) std::swap(data[i], data[reversal[i]]);
+        }
+
+        // Iterative Cooley-Tukey butterflies, written out in real arithmetic
+        for (size_t length = 2; length <= n; length <<= 1) {
+            const size_t half = length / 2;
+            const size_t stride = n / length;
+
+            for (size_t start = 0; start < n; start += length) {
+                for (size_t k = 0; k < half; k++) {
+                    const Complex w = twiddles[k * stride];
+                    const double wr = w.real();
+                    const double wi = inverse ? -w.imag() : w.imag();
+
+                    Complex& a = data[start + k];
+                    Complex& b = data[start + k + half];
+
+                    const double br = b.real() * wr - b.imag() * wi;
+                    const double bi = b.real() * wi + b.imag() * wr;
+
+                    b = Complex(a.real() - br, a.imag() - bi);
+                    a = Complex(a.real() + br, a.imag() + bi);
+                }
+            }
+        }
+
+        if (inverse) {
+            const double scale = 1.0 / static_cast<double>(n);
+            for (size_t i = 0; i < n; i++) data[i] *= scale;
+        }
+    }
+
+    void FFT::forward(Complex* data) const {
+        transform(data, false);
+    }
+
+    void FFT::inverse(Complex* data) const {
+        transform(data, true);
+    }
+
+} // namespace Math
@@ -4,6 +4,25 @@
 // Include Physics core files
 #include "headers/Body.hpp"
 #include "headers/World.hpp"
+#include "headers/BodyStorage.hpp"
+#include "headers/GravitySolver.hpp"
+#include "headers/GravityKernel.hpp"
+#include "headers/DirectSolver.hpp"
+#include "headers/BarnesHutSolver.hpp"
+#include "headers/FastMultipoleSolver.hpp"
+#include "headers/ParticleMeshSolver.hpp"
+#include "headers/SolverComparison.hpp"
+#include "headers/Scenario.hpp"
+#include "headers/Generators.hpp"
+#include "headers/SpatialHash.hpp"
+#include "headers/BodyTree.hpp"
+#include "headers/MappedFile.hpp"
+#include "headers/StepObserver.hpp"
+#include "headers/Checkpoint.hpp"
+#include "headers/AutoCheckpoint.hpp"
+#include "headers/TrajectoryWriter.hpp"
+#include "headers/TrajectoryReader.hpp"
+#include "headers/ThreadPool.hpp"
 #include "headers/Path.hpp"
 #include "headers/Constants.hpp"
 #include "headers/Property.hpp"
@@ -0,0 +1,43 @@
+#ifndef AUTO_CHECKPOINT_HPP
+#define AUTO_CHECKPOINT_HPP
+
+#include <string>
+#include <future>
+#include <chrono>
+#include <cstddef>
+
+#include "StepObserver.hpp"
+
+namespace Physics {
+
+    // Observer that checkpoints a world periodically, every n steps and/or every
+    // so many seconds of wall time. Writes run in the background; when one is still
+    // in flight the next checkpoint is deferred rather than stalling the step.
+    // Write errors are rethrown from the next World::step or from flush.
+    class AutoCheckpoint : public StepObserver {
+        std::string filename;
+        size_t everySteps;                  // 0 disables the step trigger
+        double everySeconds;                // 0 disables the wall time trigger
+
+        size_t stepsSinceSave = 0;
+        std::chrono::steady_clock::time_point lastSave;
+        std::future<void> pending;          // Write in flight
+        size_t saved = 0;
+
+    public:
+        AutoCheckpoint(const std::string& filename, size_t everySteps, double everySeconds = 0.0);
+        ~AutoCheckpoint() override;
+
+        void onStep(const World& world) override;
+
+        // Wait for the write in flight, rethrowing its error
+        void flush();
+
+        // Checkpoints started so far
+        size_t getSaveCount() const;
+        const std::string& getFilename() const;
+    };
+
+} // namespace Physics
+
+#endif // AUTO_CHECKPOINT_HPP
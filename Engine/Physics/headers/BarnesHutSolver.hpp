@@ -0,0 +1,66 @@
+#ifndef BARNES_HUT_SOLVER_HPP
+#define BARNES_HUT_SOLVER_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include "GravitySolver.hpp"
+
+namespace Physics {
+
+    // O(N log N) tree code. A quadtree is built over the body positions every
+    // step, each cell stores its mass, center of mass and quadrupole moment,
+    // and cells that look small enough from a body are used in place of the
+    // bodies they contain.
+    class BarnesHutSolver : public GravitySolver {
+    public:
+        struct Node {
+            double centerX, centerY;    // Geometric center of the square cell
+            double halfSize;            // Half of the cell's side length
+            double mass;
+            double comX, comY;          // Center of mass
+            double qxx, qxy, qyy;       // Quadrupole moment about the center of mass
+            uint32_t firstChild;        // Index of the first of 4 children, NoChild for leaves
+            uint32_t begin, end;        // Range of bodies in the sorted order
+        };
+
+        static constexpr uint32_t NoChild = 0xFFFFFFFF;
+
+    private:
+        double theta;           // Opening angle
+        double softening;       // Plummer softening length
+        bool useQuadrupole;     // Include quadrupole terms in cell interactions
+        size_t leafSize;        // Maximum number of bodies in a leaf
+
+        std::vector<Node> nodes;        // Flattened tree, root at index 0
+        std::vector<uint32_t> order;    // Body indices grouped by cell
+
+        void build(const BodyStorage& storage);
+        void buildNode(uint32_t node, const double* x, const double* y, const double* mass, int depth);
+
+    public:
+        BarnesHutSolver(double theta = 0.5, double softening = 0.0, bool useQuadrupole = true, size_t leafSize = 8);
+
+        void setTheta(double theta);
+        double getTheta() const;
+
+        void setSoftening(double softening);
+        double getSoftening() const;
+
+        void setQuadrupole(bool enabled);
+        bool quadrupoleEnabled() const;
+
+        // Acceleration of a single body from the current tree
+        void accelerationOf(const BodyStorage& storage, size_t index, double& ax, double& ay) const;
+
+        void computeAccelerations(BodyStorage& storage, ThreadPool& pool) override;
+        void computeActiveAccelerations(BodyStorage& storage, const std::vector<uint32_t>& active, ThreadPool& pool) override;
+
+        // Tree of the last evaluation
+        const std::vector<Node>& getNodes() const;
+    };
+
+} // namespace Physics
+
+#endif // BARNES_HUT_SOLVER_HPP
@@ -1,28 +1,36 @@
 #ifndef BODY_HPP
 #define BODY_HPP
 
-#include <unordered_map>
 #include <string>
 #include <memory>
 
-// Forward Declaration of Math::Vector
-namespace Math {
-    struct Vector;
-}
+#include "BodyStorage.hpp"
+
+#include "../../Math/headers/Vector.hpp"
 
 namespace Physics {
 
     // Forward Declaration 
     enum class PhysicalProperty;
     enum class KinematicProperty;
+    class World;
 
+    // Handle to a body. Once added to a World the body's state lives in the
+    // World's contiguous storage and the handle reads and writes it there.
     class Body {
+        friend class World;
+
+        World* world = nullptr; // Owning world, null while detached
+        size_t index = 0;       // Index into the owning world's storage
 
-        // Physical Properties
-        std::unordered_map<PhysicalProperty, double> physicalProperties;
+        // State used while the body is not part of a World
+        BodyState state;
 
-        // Kinematic Properties
-        std::unordered_map<KinematicProperty, Math::Vector> kinematicProperties;
+        // Locate the storage of a property
+        double* physical(PhysicalProperty property);
+        const double* physical(PhysicalProperty property) const;
+        void kinematic(KinematicProperty property, double*& x, double*& y);
+        void kinematic(KinematicProperty property, const double*& x, const double*& y) const;
 
     public:
         Body(double mass, const Math::Vector& position);
@@ -50,4 +58,4 @@ namespace Physics {
 } // namespace Physics
 
 
-#endif // BODY_HPP
\ No newline at end of file
+#endif // BODY_HPP
@@ -0,0 +1,62 @@
+#ifndef BODY_STORAGE_HPP
+#define BODY_STORAGE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Physics {
+
+    // State of a single body, used while a Body is not attached to a World
+    struct BodyState {
+        double x = 0.0, y = 0.0;    // Position
+        double vx = 0.0, vy = 0.0;  // Linear Velocity
+        double fx = 0.0, fy = 0.0;  // Force
+        double ax = 0.0, ay = 0.0;  // Acceleration
+        double mass = 0.0;
+        double invMass = 0.0;
+        double radius = 0.0;        // Collision radius, 0 for a point mass
+    };
+
+    // Structure of arrays holding the state of every body in a World.
+    // Index i of each array belongs to the same body.
+    struct BodyStorage {
+        std::vector<double> x, y;       // Position
+        std::vector<double> vx, vy;     // Linear Velocity
+        std::vector<double> fx, fy;     // Force
+        std::vector<double> ax, ay;     // Acceleration
+        std::vector<double> mass;
+        std::vector<double> invMass;
+        std::vector<double> radius;
+
+        // Number of bodies stored
+        size_t size() const;
+
+        // Reserve space for n bodies
+        void reserve(size_t n);
+
+        // Resize every array to n bodies, new bodies are zero
+        void resize(size_t n);
+
+        // Append a body
+        void push(const BodyState& state);
+
+        // Remove the body at index, keeping the order of the others
+        void erase(size_t index);
+
+        // Remove every body i with remove[i] set in one pass, keeping the order of the others
+        void compact(const std::vector<uint8_t>& remove);
+
+        // Remove all bodies
+        void clear();
+
+        // Copy the state of the body at index
+        BodyState load(size_t index) const;
+
+        // Overwrite the state of the body at index
+        void store(size_t index, const BodyState& state);
+    };
+
+} // namespace Physics
+
+#endif // BODY_STORAGE_HPP
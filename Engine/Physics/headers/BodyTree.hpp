@@ -0,0 +1,69 @@
+#ifndef BODY_TREE_HPP
+#define BODY_TREE_HPP
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+#include "BodyStorage.hpp"
+
+#include "../../Math/headers/AABBTree.hpp"
+#include "../../Math/headers/Vector.hpp"
+
+namespace Physics {
+
+    // Math::AABBTree over the discs of a set of bodies, for picking, neighbour searches
+    // and collision pairs without scanning every body.
+    //
+    // update() follows the storage between steps: only bodies that left their fat box are
+    // reinserted, so a slowly changing system costs little more than a pass over the bodies.
+    // Queries fill a caller owned vector and do not allocate once it has grown.
+    class BodyTree {
+    public:
+        using Pair = std::pair<uint32_t, uint32_t>;
+
+        // Returned by pick when no body is hit
+        static constexpr size_t None = static_cast<size_t>(-1);
+
+    private:
+        Math::AABBTree tree;
+        std::vector<int32_t> proxies;           // Proxy of every body
+        const BodyStorage* storage = nullptr;   // Storage of the last update
+
+        // Body of a proxy
+        uint32_t bodyOf(int32_t proxy) const;
+
+    public:
+        // Fat boxes are grown by margin (m) on every side
+        explicit BodyTree(double margin = 0.0);
+
+        // Bring the tree up to date with storage and keep a reference to it for queries.
+        // Fat boxes are stretched by velocity * lookAheadTime, so bodies that keep moving
+        // are reinserted less often. A change in the body count rebuilds the tree.
+        // Returns the number of bodies reinserted.
+        size_t update(const BodyStorage& storage, double lookAheadTime = 0.0);
+
+        // Drop every body
+        void clear();
+
+        // Nearest body whose disc, grown by tolerance, contains point, or None
+        size_t pick(const Math::Vector& point, double tolerance = 0.0) const;
+
+        // Replace bodies with every body whose disc meets the circle, in ascending order
+        void queryRadius(const Math::Vector& center, double radius, std::vector<size_t>& bodies) const;
+
+        // First body whose disc the ray origin + t * direction meets for 0 <= t <= maxT.
+        // Sets index and t and returns true on a hit.
+        bool raycast(const Math::Vector& origin, const Math::Vector& direction, double maxT, size_t& index, double& t) const;
+
+        // Replace pairs with every pair (i, j), i < j, of bodies whose discs overlap,
+        // in ascending order. Same result as SpatialHash::findPairs.
+        void findPairs(std::vector<Pair>& pairs) const;
+
+        const Math::AABBTree& getTree() const;
+    };
+
+} // namespace Physics
+
+#endif // BODY_TREE_HPP
@@ -0,0 +1,91 @@
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <string>
+#include <vector>
+#include <future>
+#include <cstdint>
+#include <cstddef>
+
+#include "MappedFile.hpp"
+
+namespace Physics {
+
+    class World;
+
+    // Binary snapshot of a World, memory mapped for loading.
+    //
+    // Layout, little-endian throughout:
+    //   Header (64 bytes), see below
+    //   bodyCount doubles for each of x, y, vx, vy, ax, ay, mass, radius, in that order
+    //   (version 1 files stop after mass, their bodies restore with radius 0)
+    //
+    // The arrays start at headerSize, so later versions can grow the header
+    // without breaking older readers.
+    class Checkpoint {
+    public:
+        static constexpr uint32_t Version = 2;
+        static constexpr size_t ArrayCount = 8;
+
+        struct Header {
+            char magic[8];          // "PHYSCKPT"
+            uint32_t version;
+            uint32_t headerSize;    // Offset of the first array
+            uint64_t bodyCount;
+            double time;            // World::getTime
+            uint32_t integrator;    // World::Integrator
+            uint32_t flags;         // AccelerationsValid
+            uint64_t stepCount;     // World::getStepCount, 0 in version 1 files
+            uint64_t reserved[2];
+        };
+
+        static constexpr uint32_t AccelerationsValid = 1;  // ax / ay match the positions
+
+    private:
+        MappedFile mapped;
+        Header header;
+        std::vector<double> converted;          // Byte swapped arrays on big-endian hosts
+
+        const double* array(size_t index) const;
+        size_t arrayCount() const;              // Arrays stored by the file's version
+
+    public:
+        // Map a checkpoint file and validate its header, throws std::runtime_error on failure
+        explicit Checkpoint(const std::string& filename);
+
+        Checkpoint(const Checkpoint&) = delete;
+        Checkpoint& operator=(const Checkpoint&) = delete;
+
+        size_t size() const;
+        double getTime() const;
+        const Header& getHeader() const;
+
+        // Arrays read straight from the mapping, valid while the checkpoint is alive
+        const double* x() const;
+        const double* y() const;
+        const double* vx() const;
+        const double* vy() const;
+        const double* ax() const;
+        const double* ay() const;
+        const double* mass() const;
+        const double* radius() const;           // Null for version 1 files
+
+        // Whether the file stores the step count, version 1 files do not
+        bool hasStepCount() const;
+
+        // Fill an empty world with the bodies, time, step count and integrator of the checkpoint
+        void restore(World& world) const;
+
+        // Write a checkpoint. The file is written under a temporary name and renamed
+        // into place, so a crash never leaves a truncated checkpoint behind.
+        static void save(const World& world, const std::string& filename);
+
+        // Copy the state and write it on a background thread. The copy is the only work
+        // done on the calling thread. Keep the future: its destructor waits for the write,
+        // and get() rethrows any I/O error.
+        static std::future<void> saveAsync(const World& world, const std::string& filename);
+    };
+
+} // namespace Physics
+
+#endif // CHECKPOINT_HPP
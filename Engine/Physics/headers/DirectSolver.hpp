@@ -0,0 +1,82 @@
+#ifndef DIRECT_SOLVER_HPP
+#define DIRECT_SOLVER_HPP
+
+#include <vector>
+
+#include "GravitySolver.hpp"
+#include "GravityKernel.hpp"
+
+namespace Physics {
+
+    // Exact O(N^2) pairwise summation. Targets are split into tiles that are
+    // spread over the thread pool, and sources are visited in blocks small
+    // enough to stay in cache while a tile is summed against them.
+    //
+    // In symmetric mode every unordered pair is evaluated once and applied to
+    // both bodies (Newton's third law), halving the distance computations.
+    // Rows of the pair triangle are split into a fixed number of chunks, each with
+    // its own accumulation buffer, which are spread over the pool and reduced in
+    // chunk order, so the result depends neither on the thread count nor on scheduling.
+    //
+    // In mixed precision the state stays in double, but each evaluation converts positions
+    // and masses to float in normalised units: positions relative to the centre of the
+    // bodies' extent in units of its half width, masses in units of the total mass.
+    // Positions are stored as a float and its float remainder, so separations keep float
+    // precision however small they are next to the system. The pairwise math runs on float
+    // lanes and the sums are compensated in double (see GravityKernel).
+    class DirectSolver : public GravitySolver {
+    public:
+        enum class Precision {
+            Double,     // Everything in double
+            Mixed       // Float pairwise math, compensated double sums
+        };
+
+        static constexpr size_t TileSize = 64;      // Targets per task
+        static constexpr size_t BlockSize = 2048;   // Sources kept in cache per pass
+        static constexpr size_t SymmetricChunks = 16;  // Pair triangle chunks in symmetric mode
+
+    private:
+        double softening;           // Plummer softening length
+        GravityKernel::Isa kernel;  // Instruction set of the pairwise kernel
+        bool symmetric = false;     // Evaluate each pair once
+        Precision precision = Precision::Double;
+
+        std::vector<double> buffers;    // Per-chunk accelerations in symmetric mode, x then y
+        std::vector<float> unitX, unitY, unitXLow, unitYLow, unitMass;  // Normalised float state in mixed precision
+
+        void computeSymmetric(BodyStorage& storage, ThreadPool& pool);
+
+        // Fill the normalised float state and return the factor taking accelerations
+        // in those units back to SI, sets eps2 to the softening in those units
+        double normalize(const BodyStorage& storage, ThreadPool& pool, float& eps2);
+
+        // Evaluate the listed bodies, or every body if active is null, in mixed precision
+        void computeMixed(BodyStorage& storage, const std::vector<uint32_t>* active, ThreadPool& pool);
+
+    public:
+        DirectSolver(double softening = 0.0);
+
+        void setSoftening(double softening);
+        double getSoftening() const;
+
+        // Kernel selection, the widest one the CPU supports by default
+        void setKernel(GravityKernel::Isa kernel);
+        GravityKernel::Isa getKernel() const;
+
+        // Use Newton's third law to evaluate each pair once, double precision only
+        void setSymmetric(bool enabled);
+        bool isSymmetric() const;
+
+        // Precision of the pairwise math, Double by default
+        void setPrecision(Precision precision);
+        Precision getPrecision() const;
+
+        void computeAccelerations(BodyStorage& storage, ThreadPool& pool) override;
+
+        // Sums each active target over every source, symmetric mode does not apply
+        void computeActiveAccelerations(BodyStorage& storage, const std::vector<uint32_t>& active, ThreadPool& pool) override;
+    };
+
+} // namespace Physics
+
+#endif // DIRECT_SOLVER_HPP
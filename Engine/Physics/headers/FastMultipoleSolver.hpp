@@ -0,0 +1,84 @@
+#ifndef FAST_MULTIPOLE_SOLVER_HPP
+#define FAST_MULTIPOLE_SOLVER_HPP
+
+#include <vector>
+#include <complex>
+#include <cstdint>
+
+#include "GravitySolver.hpp"
+
+namespace Physics {
+
+    // O(N) Fast Multipole Method on a uniform quadtree.
+    //
+    // Positions are treated as complex numbers z = x + iy. The planar 1/r kernel
+    // is expanded as 1/|z - w| = (z - w)^(-1/2) (conj(z) - conj(w))^(-1/2), which gives
+    // complex multipole moments M_pq = sum m u^p conj(u)^q and local coefficients L_pq
+    // of s^p conj(s)^q, truncated at p + q <= order. The usual translations
+    // (P2M, M2M, M2L, L2L, L2P) carry the far field, and adjacent leaves are
+    // summed directly.
+    class FastMultipoleSolver : public GravitySolver {
+    public:
+        using Complex = std::complex<double>;
+
+        static constexpr int MaxOrder = 20;
+        static constexpr int MaxLevel = 10;
+
+    private:
+        int order;          // Expansion order p
+        size_t leafSize;    // Average bodies per leaf used to pick the tree depth
+        double softening;   // Plummer softening length for near-field pairs
+
+        // Precomputed coefficients
+        int terms = 0;                          // Number of (p, q) pairs with p + q <= order
+        std::vector<int> index;                 // index[p * (order + 1) + q], position of (p, q) in a coefficient block
+        std::vector<double> binomial;           // C(n, k) for n, k <= order
+        std::vector<double> multipoleScale;     // a_p a_q with a_p = C(2p, p) / 4^p
+        std::vector<double> localScale;         // binom(-p - 1/2, k)
+
+        // Tree of the last evaluation
+        int levels = 0;                         // Finest level
+        double originX = 0.0, originY = 0.0;    // Corner of the root box
+        double size = 1.0;                      // Side of the root box
+        std::vector<uint32_t> counts;           // Bodies per box, all levels
+        std::vector<uint32_t> leafStart;        // Range of each finest-level box in the sorted order
+        std::vector<uint32_t> sorted;           // Body indices sorted by leaf
+        std::vector<double> sx, sy, sm;         // Sorted positions (in root box units) and masses
+        std::vector<Complex> multipoles;        // Per box, terms coefficients each
+        std::vector<Complex> locals;            // Per box, terms coefficients each
+
+        void prepare();
+        void build(const BodyStorage& storage);
+
+        static size_t levelOffset(int level);
+        Complex center(int level, uint32_t ix, uint32_t iy) const;
+
+        int idx(int p, int q) const { return index[p * (order + 1) + q]; }
+
+        void particleToMultipole(uint32_t leaf);
+        void multipoleToMultipole(int level, uint32_t ix, uint32_t iy);
+        void multipoleToLocal(const Complex* multipole, Complex z, Complex* local, Complex* scratch) const;
+        void localToLocal(int level, uint32_t ix, uint32_t iy);
+        void evaluateLeaf(uint32_t ix, uint32_t iy, double* ax, double* ay) const;
+
+    public:
+        FastMultipoleSolver(int order = 8, size_t leafSize = 32, double softening = 0.0);
+
+        void setOrder(int order);
+        int getOrder() const;
+
+        void setLeafSize(size_t leafSize);
+        size_t getLeafSize() const;
+
+        void setSoftening(double softening);
+        double getSoftening() const;
+
+        // Finest level of the last tree
+        int getLevels() const;
+
+        void computeAccelerations(BodyStorage& storage, ThreadPool& pool) override;
+    };
+
+} // namespace Physics
+
+#endif // FAST_MULTIPOLE_SOLVER_HPP
@@ -0,0 +1,87 @@
+#ifndef GENERATORS_HPP
+#define GENERATORS_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include "BodyStorage.hpp"
+
+namespace Physics {
+
+    class World;
+    class ThreadPool;
+
+    // Initial conditions built from standard distributions (SI units).
+    //
+    // Body i draws from its own Math::Philox stream (seed, i), so the bodies are
+    // generated in parallel and the result is bitwise identical for a given seed and
+    // body count, whatever the thread count. Generated systems are shifted to their
+    // centre of mass frame unless centerOfMassFrame is false.
+    class Generators {
+    public:
+        // Plummer star cluster: the 3D model of Aarseth, Henon & Wielen (1974) projected
+        // onto the plane. The surface density is the projected Plummer profile
+        // sigma(R) ~ (1 + R^2 / a^2)^-2; the planar system is close to, not exactly in, equilibrium.
+        struct PlummerOptions {
+            size_t count = 10000;
+            double totalMass = 1.989e36;        // 10^6 solar masses
+            double scaleRadius = 3.086e16;      // a, 1 pc
+            double maxRadius = 10.0;            // Bodies beyond maxRadius * a are redrawn
+            bool centerOfMassFrame = true;
+        };
+
+        // Exponential disk sigma(R) ~ exp(-R / Rd) on circular orbits of Freeman's (1970) thin
+        // disk rotation curve, plus an optional central mass and Gaussian velocity dispersion
+        struct DiskOptions {
+            size_t count = 10000;
+            double diskMass = 1.0e41;           // About 5 * 10^10 solar masses
+            double scaleLength = 9.26e19;       // Rd, 3 kpc
+            double maxRadius = 10.0;            // Bodies beyond maxRadius * Rd are redrawn
+            double centralMass = 0.0;           // Extra body at the centre, 0 for none
+            double centralRadius = 0.0;         // Collision radius of the central body
+            double radius = 0.0;                // Collision radius of the disk bodies, 0 for point masses
+            double dispersion = 0.05;           // Velocity dispersion as a fraction of the circular speed
+            bool centerOfMassFrame = true;
+        };
+
+        // Debris ring around a central body on Keplerian orbits. Semi-major axes are uniform
+        // in area between the radii, eccentricities Rayleigh distributed, orbits prograde.
+        struct RingOptions {
+            size_t count = 10000;               // Ring bodies, the central body comes first on top of these
+            double centralMass = 1.989e30;      // Sun
+            double centralRadius = 0.0;         // Collision radius of the central body
+            double innerRadius = 3.29e11;       // 2.2 AU
+            double outerRadius = 4.94e11;       // 3.3 AU
+            double particleMass = 1.0e18;
+            double radius = 0.0;                // Collision radius of the ring bodies, 0 for point masses
+            double eccentricity = 0.05;         // Rayleigh scale of the eccentricities, below 0.9
+            bool centerOfMassFrame = true;
+        };
+
+        // Bodies uniformly placed in a square with uniform masses and Gaussian velocities
+        struct BoxOptions {
+            size_t count = 10000;
+            double halfSize = 1.0e11;           // Square [-halfSize, halfSize]^2
+            double minMass = 1.0e20;
+            double maxMass = 1.0e24;
+            double radius = 0.0;                // Collision radius of every body, 0 for point masses
+            double velocityDispersion = 0.0;    // Per component standard deviation (m/s)
+            bool centerOfMassFrame = true;
+        };
+
+        static BodyStorage plummer(const PlummerOptions& options, uint64_t seed, ThreadPool& pool);
+        static BodyStorage disk(const DiskOptions& options, uint64_t seed, ThreadPool& pool);
+        static BodyStorage ring(const RingOptions& options, uint64_t seed, ThreadPool& pool);
+        static BodyStorage box(const BoxOptions& options, uint64_t seed, ThreadPool& pool);
+
+        // Generate on world.getThreadCount() threads and add the bodies to the world,
+        // returns how many were added. Throws std::invalid_argument for invalid options.
+        static size_t plummer(World& world, const PlummerOptions& options, uint64_t seed);
+        static size_t disk(World& world, const DiskOptions& options, uint64_t seed);
+        static size_t ring(World& world, const RingOptions& options, uint64_t seed);
+        static size_t box(World& world, const BoxOptions& options, uint64_t seed);
+    };
+
+} // namespace Physics
+
+#endif // GENERATORS_HPP
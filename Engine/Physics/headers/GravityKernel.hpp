@@ -0,0 +1,94 @@
+#ifndef GRAVITY_KERNEL_HPP
+#define GRAVITY_KERNEL_HPP
+
+#include <cstddef>
+
+namespace Physics {
+
+    // Pairwise gravity kernels used by the direct solver.
+    // A kernel adds sum_j m_j * d_ij / (|d_ij|^2 + eps2)^(3/2) for sources j in [jBegin, jEnd)
+    // to sumX / sumY[i - iBegin] for every target i in [iBegin, iEnd). Pairs at zero distance
+    // (including i == j) contribute nothing. The result is not multiplied by G.
+    //
+    // Symmetric kernels visit each unordered pair once: for every i in [iBegin, iEnd) and
+    // j in (i, n) they add m_j * d_ij / r^3 to accX/accY[i] and subtract m_i * d_ij / r^3
+    // from accX/accY[j], where accX/accY cover all n bodies.
+    //
+    // Mixed kernels take float masses and positions split into a float and the float rounding
+    // error of the remainder (x + xLow), normally in units where both are of order one, and do
+    // the pairwise math in float with twice as many lanes per instruction. Differences of the
+    // high parts of nearby bodies are exact, so the separation keeps float relative precision.
+    // Lane sums only ever cover a short run of sources before they are flushed into double
+    // Kahan sums, and each call adds its total to sumX / sumY[i - iBegin] with the rounding
+    // error carried in compensationX / compensationY, so sum + compensation is the result.
+    class GravityKernel {
+    public:
+        enum class Isa {
+            Scalar,     // Portable C++
+            AVX2,       // 4 sources per instruction, AVX2 + FMA
+            AVX512      // 8 sources per instruction, AVX-512F
+        };
+
+        using Function = void (*)(const double* x, const double* y, const double* mass,
+            size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, double eps2,
+            double* sumX, double* sumY);
+
+        using SymmetricFunction = void (*)(const double* x, const double* y, const double* mass, size_t n,
+            size_t iBegin, size_t iEnd, double eps2, double* accX, double* accY);
+
+        using MixedFunction = void (*)(const float* x, const float* y, const float* xLow, const float* yLow, const float* mass,
+            size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, float eps2,
+            double* sumX, double* sumY, double* compensationX, double* compensationY);
+
+        // Widest instruction set supported by this CPU
+        static Isa detect();
+
+        // Check if this CPU (and build) can run a kernel
+        static bool supported(Isa isa);
+
+        // Kernel for an instruction set, falls back to scalar if unsupported
+        static Function get(Isa isa);
+
+        static SymmetricFunction getSymmetric(Isa isa);
+
+        static MixedFunction getMixed(Isa isa);
+
+        static const char* name(Isa isa);
+
+        static void scalar(const double* x, const double* y, const double* mass,
+            size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, double eps2,
+            double* sumX, double* sumY);
+
+        static void avx2(const double* x, const double* y, const double* mass,
+            size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, double eps2,
+            double* sumX, double* sumY);
+
+        static void avx512(const double* x, const double* y, const double* mass,
+            size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, double eps2,
+            double* sumX, double* sumY);
+
+        static void scalarSymmetric(const double* x, const double* y, const double* mass, size_t n,
+            size_t iBegin, size_t iEnd, double eps2, double* accX, double* accY);
+
+        static void avx2Symmetric(const double* x, const double* y, const double* mass, size_t n,
+            size_t iBegin, size_t iEnd, double eps2, double* accX, double* accY);
+
+        static void avx512Symmetric(const double* x, const double* y, const double* mass, size_t n,
+            size_t iBegin, size_t iEnd, double eps2, double* accX, double* accY);
+
+        static void scalarMixed(const float* x, const float* y, const float* xLow, const float* yLow, const float* mass,
+            size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, float eps2,
+            double* sumX, double* sumY, double* compensationX, double* compensationY);
+
+        static void avx2Mixed(const float* x, const float* y, const float* xLow, const float* yLow, const float* mass,
+            size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, float eps2,
+            double* sumX, double* sumY, double* compensationX, double* compensationY);
+
+        static void avx512Mixed(const float* x, const float* y, const float* xLow, const float* yLow, const float* mass,
+            size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, float eps2,
+            double* sumX, double* sumY, double* compensationX, double* compensationY);
+    };
+
+} // namespace Physics
+
+#endif // GRAVITY_KERNEL_HPP
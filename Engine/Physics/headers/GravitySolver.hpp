@@ -0,0 +1,30 @@
+#ifndef GRAVITY_SOLVER_HPP
+#define GRAVITY_SOLVER_HPP
+
+#include <vector>
+#include <cstdint>
+
+namespace Physics {
+
+    struct BodyStorage;
+    class ThreadPool;
+
+    // Interface of the algorithms World can use to evaluate gravity
+    class GravitySolver {
+    public:
+        virtual ~GravitySolver() = default;
+
+        // Fill storage.ax / storage.ay with the gravitational acceleration of every body.
+        // Work may be spread over the pool, but results must not depend on its size.
+        virtual void computeAccelerations(BodyStorage& storage, ThreadPool& pool) = 0;
+
+        // Update the accelerations of the listed bodies only, every body still acts as a source.
+        // Other accelerations are left untouched. The default evaluates every body and restores
+        // the others, solvers that can evaluate single targets should override it. DirectSolver and
+        // BarnesHutSolver do; FastMultipoleSolver and ParticleMeshSolver use the default.
+        virtual void computeActiveAccelerations(BodyStorage& storage, const std::vector<uint32_t>& active, ThreadPool& pool);
+    };
+
+} // namespace Physics
+
+#endif // GRAVITY_SOLVER_HPP
@@ -0,0 +1,39 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <string>
+#include <cstddef>
+
+namespace Physics {
+
+    // Read-only memory mapping of a whole file (mmap on POSIX, MapViewOfFile on Windows).
+    // An empty file maps to a null pointer with size 0.
+    class MappedFile {
+        const unsigned char* data = nullptr;
+        size_t length = 0;
+
+#ifdef _WIN32
+        void* file = nullptr;
+        void* mapping = nullptr;
+#else
+        int file = -1;
+#endif
+
+        void close();
+
+    public:
+        // Throws std::runtime_error if the file cannot be opened or mapped
+        explicit MappedFile(const std::string& filename);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        const unsigned char* begin() const;
+        const unsigned char* end() const;
+        size_t size() const;
+    };
+
+} // namespace Physics
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,85 @@
+#ifndef PARTICLE_MESH_SOLVER_HPP
+#define PARTICLE_MESH_SOLVER_HPP
+
+#include <vector>
+#include <complex>
+#include <memory>
+#include <cstdint>
+
+#include "GravitySolver.hpp"
+#include "../../Math/headers/FFT.hpp"
+
+namespace Physics {
+
+    // Particle-mesh gravity. Masses are deposited on a square grid, convolved
+    // with the 1/r^2 force kernel through zero padded FFTs (isolated boundaries),
+    // and the mesh accelerations are interpolated back with the same scheme.
+    //
+    // With the short-range correction enabled (P3M) the kernel is split with a
+    // Gaussian of width splitScale cells: the mesh carries the smooth long-range
+    // part and pairs closer than cutoff * splitScale cells are summed directly.
+    class ParticleMeshSolver : public GravitySolver {
+    public:
+        using Complex = std::complex<double>;
+
+        enum class Assignment {
+            CIC,    // Cloud in cell, 2x2 cells
+            TSC     // Triangular shaped cloud, 3x3 cells
+        };
+
+    private:
+        size_t gridSize;            // Cells per side of the mass grid, a power of two
+        Assignment assignment;
+        bool shortRange;            // Add the P3M direct correction
+        double splitScale;          // Force split scale in cells
+        double cutoff;              // Short-range cutoff in units of splitScale
+        double softening;           // Plummer softening length
+
+        // Mesh geometry, kept while the bodies fit so the kernel is not rebuilt every step
+        double originX = 0.0, originY = 0.0;
+        double cellSize = 0.0;
+        bool kernelReady = false;
+
+        std::unique_ptr<Math::FFT> fft;     // Length 2 * gridSize
+        std::vector<Complex> kernel;        // Transformed (Kx + i Ky) on the padded grid
+        std::vector<Complex> grid;          // Padded work grid
+
+        std::vector<uint32_t> rowStart;     // Bodies binned by grid row, for the deposit
+        std::vector<uint32_t> rowBodies;
+
+        std::vector<uint32_t> chainStart;   // Bodies binned by short-range cell
+        std::vector<uint32_t> chainBodies;
+
+        bool updateGeometry(const BodyStorage& storage);
+        void buildKernel(ThreadPool& pool);
+        void transform(ThreadPool& pool, bool inverse);
+        int weights(double position, double origin, double w[3]) const;
+        void deposit(const BodyStorage& storage, ThreadPool& pool);
+        void interpolate(BodyStorage& storage, ThreadPool& pool) const;
+        void addShortRange(BodyStorage& storage, ThreadPool& pool);
+
+    public:
+        ParticleMeshSolver(size_t gridSize = 256, Assignment assignment = Assignment::TSC, bool shortRange = false);
+
+        void setGridSize(size_t gridSize);
+        size_t getGridSize() const;
+
+        void setAssignment(Assignment assignment);
+        Assignment getAssignment() const;
+
+        // Enable the P3M short-range correction
+        void setShortRange(bool enabled, double splitScale = 1.25, double cutoff = 4.5);
+        bool shortRangeEnabled() const;
+
+        void setSoftening(double softening);
+        double getSoftening() const;
+
+        // Side of a mesh cell in the last evaluation
+        double getCellSize() const;
+
+        void computeAccelerations(BodyStorage& storage, ThreadPool& pool) override;
+    };
+
+} // namespace Physics
+
+#endif // PARTICLE_MESH_SOLVER_HPP
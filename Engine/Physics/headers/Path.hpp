@@ -2,28 +2,52 @@
 #define PATH_HPP
 
 #include <vector>
-#include <unordered_map>
+#include <cstddef>
 
-namespace Math {
-    struct Vector;
-}
+#include "../../Math/headers/Vector.hpp"
 
 namespace Physics {
 
+    // Trail of positions with bounded memory. Points live in a fixed-capacity ring
+    // buffer and a new point is only taken once the body has moved minDistance from
+    // the last one. When the buffer is full the older half is thinned to every second
+    // point, so old history gets progressively coarser instead of growing. With
+    // downsampling disabled the oldest point is overwritten instead.
     class Path {
     private:
-        std::vector<size_t> hashList;  // List of hashes for the order of insertion
-        std::unordered_map<size_t, Math::Vector> hashToVector;  // Map from hash to vector
+        std::vector<Math::Vector> points;   // Ring buffer, capacity slots
+        size_t head = 0;                    // Index of the oldest point
+        size_t count = 0;                   // Points in use
+        double minDistance;                 // Minimum spacing between points (world units)
+        bool downsample;                    // Thin old history instead of dropping it
+        size_t revision = 0;                // Bumped whenever existing points change
+
+        void compact();
 
     public:
-        // Insert a Position
+        Path(size_t capacity = 1024, double minDistance = 0.0, bool downsample = true);
+
+        // Insert a Position, ignored if closer than minDistance to the last point
         void insert(const Math::Vector& v);
 
-        // Get the i-th position in the path
-        Math::Vector get(int i) const;
+        // Get the i-th position in the path, 0 is the oldest
+        const Math::Vector& get(int i) const;
+
+        // Most recent position
+        const Math::Vector& back() const;
 
         // Get the size of the path
         size_t getSize() const;
+        size_t getCapacity() const;
+
+        // Changes whenever points already in the path are thinned, dropped or cleared,
+        // but not when one is appended, so caches built from the path know when to rebuild
+        size_t getRevision() const;
+
+        void setMinDistance(double distance);
+        double getMinDistance() const;
+
+        void clear();
     };
 
 } // namespace Physics
@@ -31,4 +55,4 @@ namespace Physics {
 
 
 
-#endif // PATH_HPP
\ No newline at end of file
+#endif // PATH_HPP
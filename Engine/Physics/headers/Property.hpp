@@ -8,6 +8,7 @@ namespace Physics {
     enum class PhysicalProperty {
         Mass,
         InverseMass,
+        Radius,         // Collision radius, 0 for a point mass
     };
 
     enum class KinematicProperty {
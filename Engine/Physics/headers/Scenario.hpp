@@ -0,0 +1,25 @@
+#ifndef SCENARIO_HPP
+#define SCENARIO_HPP
+
+#include <string>
+
+namespace Physics {
+
+    class World;
+
+    // Scenario files are CSV with a header line and one body per row:
+    // mass,distanceX,distanceY,velocityX,velocityY[,radius] (SI units)
+    class Scenario {
+    public:
+        // Add the bodies of a scenario file to the world and return how many were added.
+        // The file is mapped and parsed in parallel chunks on world.getThreadCount() threads.
+        // Throws std::runtime_error naming the file and line on I/O or parse errors.
+        static size_t load(const std::string& filename, World& world);
+
+        // Write the current state of the world in the same format, so it can be loaded again
+        static void save(const std::string& filename, const World& world);
+    };
+
+} // namespace Physics
+
+#endif // SCENARIO_HPP
@@ -0,0 +1,34 @@
+#ifndef SOLVER_COMPARISON_HPP
+#define SOLVER_COMPARISON_HPP
+
+#include <string>
+#include <cstddef>
+
+namespace Physics {
+
+    class GravitySolver;
+    class ThreadPool;
+    struct BodyStorage;
+
+    // Accuracy and speed of a solver measured against a reference solver on the same bodies
+    struct SolverComparison {
+        size_t bodies = 0;
+        double referenceSeconds = 0.0;  // Time of one reference evaluation
+        double candidateSeconds = 0.0;  // Time of one candidate evaluation
+        double maxRelativeError = 0.0;  // Largest |a - a_ref| / |a_ref| over all bodies
+        double rmsRelativeError = 0.0;  // Root mean square of the same
+        double medianRelativeError = 0.0;
+
+        double speedup() const;
+
+        // One line summary
+        std::string toString() const;
+
+        // Evaluate both solvers on a copy of storage and compare the accelerations
+        static SolverComparison compare(GravitySolver& reference, GravitySolver& candidate,
+            const BodyStorage& storage, ThreadPool& pool);
+    };
+
+} // namespace Physics
+
+#endif // SOLVER_COMPARISON_HPP
@@ -0,0 +1,49 @@
+#ifndef SPATIAL_HASH_HPP
+#define SPATIAL_HASH_HPP
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+#include "BodyStorage.hpp"
+
+namespace Physics {
+
+    class ThreadPool;
+
+    // Broad phase collision detection over a uniform grid hashed into a bucket table.
+    //
+    // Bodies with a radius take part. Cells are as wide as the largest typical diameter,
+    // so a body only meets bodies of its own and the eight neighbouring cells, and finding
+    // all overlapping pairs is O(N) expected. Bodies much larger than the typical one (more
+    // than four times the mean radius) would make the cells too coarse; they are tested
+    // against every other body instead. Buffers are kept between calls.
+    class SpatialHash {
+    public:
+        using Pair = std::pair<uint32_t, uint32_t>;
+
+    private:
+        double cellSize = 0.0;
+        std::vector<uint32_t> participants;     // Bodies with a radius
+        std::vector<uint32_t> large;            // Participants tested against everyone
+        std::vector<uint8_t> isLarge;           // Per body
+        std::vector<int64_t> cellX, cellY;      // Cell of every body
+        std::vector<uint32_t> bucketOf;         // Bucket of every participant
+        std::vector<uint32_t> bucketStart;      // Start of each bucket in sorted, plus the end
+        std::vector<uint32_t> bucketCursor;     // Next free slot of each bucket while sorting
+        std::vector<uint32_t> sorted;           // Small participants ordered by bucket
+        std::vector<std::vector<Pair>> threadPairs;
+
+    public:
+        // Replace pairs with every pair (i, j), i < j, of bodies whose discs overlap,
+        // in ascending order. Bodies with radius 0 never collide.
+        void findPairs(const BodyStorage& storage, ThreadPool& pool, std::vector<Pair>& pairs);
+
+        // Cell width chosen by the last findPairs
+        double getCellSize() const;
+    };
+
+} // namespace Physics
+
+#endif // SPATIAL_HASH_HPP
@@ -0,0 +1,19 @@
+#ifndef STEP_OBSERVER_HPP
+#define STEP_OBSERVER_HPP
+
+namespace Physics {
+
+    class World;
+
+    // Receives the world after every World::step, once the bodies and the time have advanced.
+    // Observers run on the thread calling step and should hand slow work (I/O) to another thread.
+    class StepObserver {
+    public:
+        virtual ~StepObserver() = default;
+
+        virtual void onStep(const World& world) = 0;
+    };
+
+} // namespace Physics
+
+#endif // STEP_OBSERVER_HPP
@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+
+namespace Physics {
+
+    // Fixed set of worker threads that run batches of independent tasks.
+    // The calling thread takes part in every batch as thread 0.
+    class ThreadPool {
+    public:
+        using Task = std::function<void(size_t task, size_t thread)>;
+        using RangeTask = std::function<void(size_t begin, size_t end, size_t thread)>;
+
+    private:
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable wake;       // Signals workers that a batch is ready
+        std::condition_variable finished;   // Signals the caller that workers are done
+
+        const Task* job = nullptr;          // Current batch
+        size_t taskCount = 0;
+        std::atomic<size_t> nextTask{ 0 };
+        size_t generation = 0;              // Incremented for every batch
+        size_t busyWorkers = 0;
+        bool stopping = false;
+        std::exception_ptr error;           // First exception thrown by a task
+
+        void workerLoop(size_t thread);
+        void drain(size_t thread);
+
+    public:
+        // 0 threads uses every hardware thread
+        explicit ThreadPool(size_t threads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // Number of threads taking part in a batch, including the caller
+        size_t size() const;
+
+        // Run task(0..tasks-1) across the pool and wait for all of them
+        void run(size_t tasks, const Task& task);
+
+        // Split [0, count) into chunks of at most grain items and run them across the pool
+        void parallelFor(size_t count, size_t grain, const RangeTask& task);
+    };
+
+} // namespace Physics
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,96 @@
+#ifndef TRAJECTORY_FORMAT_HPP
+#define TRAJECTORY_FORMAT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Physics {
+
+    // Byte level layout shared by TrajectoryWriter and TrajectoryReader. All fixed width
+    // fields are little-endian.
+    //
+    //   File header   "PHYSTRAJ", u32 version, u32 reserved, f64 positionQuantum, f64 velocityQuantum
+    //   Chunk         "CHNK", u32 frameCount, u64 payloadBytes, payload
+    //   Frame         varint step, f64 time, varint bodyCount, u8 flags,
+    //                 then bodyCount zigzag varints for each of x, y, vx, vy
+    //
+    // Values are quantized to integer multiples of the quanta. A keyframe stores the
+    // quantized values, other frames the difference to the previous frame. Every chunk
+    // starts with a keyframe, so chunks decode independently.
+    namespace TrajectoryFormat {
+
+        static constexpr char FileMagic[8] = { 'P', 'H', 'Y', 'S', 'T', 'R', 'A', 'J' };
+        static constexpr char ChunkMagic[4] = { 'C', 'H', 'N', 'K' };
+        static constexpr uint32_t Version = 1;
+        static constexpr size_t FileHeaderSize = 32;
+        static constexpr size_t ChunkHeaderSize = 16;
+        static constexpr uint8_t Keyframe = 1;
+
+        inline void putU32(std::vector<uint8_t>& out, uint32_t value) {
+            for (int b = 0; b < 4; b++) out.push_back(static_cast<uint8_t>(value >> (8 * b)));
+        }
+
+        inline void putU64(std::vector<uint8_t>& out, uint64_t value) {
+            for (int b = 0; b < 8; b++) out.push_back(static_cast<uint8_t>(value >> (8 * b)));
+        }
+
+        inline void putF64(std::vector<uint8_t>& out, double value) {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            putU64(out, bits);
+        }
+
+        inline uint32_t getU32(const uint8_t* in) {
+            uint32_t value = 0;
+            for (int b = 0; b < 4; b++) value |= uint32_t(in[b]) << (8 * b);
+            return value;
+        }
+
+        inline uint64_t getU64(const uint8_t* in) {
+            uint64_t value = 0;
+            for (int b = 0; b < 8; b++) value |= uint64_t(in[b]) << (8 * b);
+            return value;
+        }
+
+        inline double getF64(const uint8_t* in) {
+            uint64_t bits = getU64(in);
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        // LEB128, 7 bits per byte, high bit set on all but the last byte
+        inline void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<uint8_t>(value) | 0x80);
+                value >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        // Returns false if the varint runs past end
+        inline bool getVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value) {
+            value = 0;
+            for (int shift = 0; in < end && shift < 64; shift += 7) {
+                uint8_t byte = *in++;
+                value |= uint64_t(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return true;
+            }
+            return false;
+        }
+
+        // Map signed to unsigned so small magnitudes give short varints
+        inline uint64_t zigzag(int64_t value) {
+            return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+        }
+
+        inline int64_t unzigzag(uint64_t value) {
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+    } // namespace TrajectoryFormat
+
+} // namespace Physics
+
+#endif // TRAJECTORY_FORMAT_HPP
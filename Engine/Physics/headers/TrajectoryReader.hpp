@@ -0,0 +1,47 @@
+#ifndef TRAJECTORY_READER_HPP
+#define TRAJECTORY_READER_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+
+namespace Physics {
+
+    // Sequential decoder for files written by TrajectoryWriter
+    class TrajectoryReader {
+    public:
+        struct Frame {
+            uint64_t step = 0;              // Steps observed by the writer when the frame was taken
+            double time = 0.0;              // World time
+            std::vector<double> x, y, vx, vy;
+        };
+
+    private:
+        std::ifstream file;
+        std::string filename;
+        uint64_t fileSize = 0;              // Bounds the chunk sizes the file can claim
+        double positionQuantum = 0.0;
+        double velocityQuantum = 0.0;
+
+        std::vector<uint8_t> chunk;         // Payload of the current chunk
+        size_t offset = 0;                  // Read position in chunk
+        uint32_t framesLeft = 0;            // Frames not yet decoded in chunk
+        std::vector<int64_t> previous;      // Quantized values of the last frame
+
+        bool readChunk();
+
+    public:
+        // Open a trajectory and read its header, throws std::runtime_error on failure
+        explicit TrajectoryReader(const std::string& filename);
+
+        // Decode the next frame, false at the end of the file
+        bool next(Frame& frame);
+
+        double getPositionQuantum() const;
+        double getVelocityQuantum() const;
+    };
+
+} // namespace Physics
+
+#endif // TRAJECTORY_READER_HPP
@@ -0,0 +1,93 @@
+#ifndef TRAJECTORY_WRITER_HPP
+#define TRAJECTORY_WRITER_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstdint>
+
+#include "StepObserver.hpp"
+
+namespace Physics {
+
+    // Observer that streams body positions and velocities to a compressed file,
+    // see TrajectoryFormat.hpp for the layout.
+    //
+    // The step thread only copies the state into a frame buffer; quantizing, delta
+    // encoding and writing happen on a background thread. Frames are handed over
+    // through a double buffer, so step waits only if the writer is a full frame behind.
+    class TrajectoryWriter : public StepObserver {
+    public:
+        struct Options {
+            size_t decimation = 1;              // Record after every n-th step
+            double positionQuantum = 1.0e3;     // Position resolution (m)
+            double velocityQuantum = 1.0e-3;    // Velocity resolution (m/s)
+            size_t framesPerChunk = 64;         // Frames between keyframes
+            uint64_t maxBytes = 0;              // Stop recording beyond this file size, 0 for no limit
+        };
+
+    private:
+        struct Frame {
+            uint64_t step = 0;
+            double time = 0.0;
+            std::vector<double> x, y, vx, vy;
+        };
+
+        Options options;
+        std::ofstream file;
+        uint64_t steps = 0;                 // Steps observed
+        std::atomic<uint64_t> framesWritten = 0;
+        std::atomic<uint64_t> bytesWritten = 0;
+        std::atomic<bool> full = false;     // maxBytes reached
+
+        // Double buffer: the step thread fills `filling`, the writer drains `queued`
+        Frame filling;
+        Frame queued;
+        bool queuedReady = false;
+        bool stopping = false;
+        std::exception_ptr error;           // First writer error, rethrown on the step thread
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::thread writer;
+
+        // Writer thread state
+        Frame current;
+        std::vector<int64_t> previous;      // Quantized values of the previous frame, x y vx vy
+        std::vector<uint8_t> chunk;         // Encoded frames of the open chunk
+        uint32_t chunkFrames = 0;
+
+        void writerLoop();
+        void encode(const Frame& frame);
+        void flushChunk();
+        void rethrow();
+
+    public:
+        TrajectoryWriter(const std::string& filename, const Options& options);
+        explicit TrajectoryWriter(const std::string& filename);
+        ~TrajectoryWriter() override;
+
+        TrajectoryWriter(const TrajectoryWriter&) = delete;
+        TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+        void onStep(const World& world) override;
+
+        // Record the current state regardless of the decimation
+        void record(const World& world);
+
+        // Write every queued frame and the open chunk, then stop. Called by the destructor.
+        void close();
+
+        uint64_t getFramesWritten() const;
+        uint64_t getBytesWritten() const;
+        bool isFull() const;
+    };
+
+} // namespace Physics
+
+#endif // TRAJECTORY_WRITER_HPP
@@ -3,28 +3,154 @@
 
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <utility>
+
+#include "BodyStorage.hpp"
 
 namespace Physics {
 
     class Body;
+    class GravitySolver;
+    class ThreadPool;
+    class StepObserver;
+    class Checkpoint;
+    class SpatialHash;
 
     class World {
-        std::vector<std::shared_ptr<Body>> bodies;
+    public:
+        // Time integration schemes used by step
+        enum class Integrator {
+            SemiImplicitEuler,  // First order, one force evaluation per step
+            Leapfrog,           // Kick-drift-kick, second order, one force evaluation per step
+            Yoshida4,           // Fourth order composition of leapfrog, three force evaluations per step
+            BlockLeapfrog       // Leapfrog with individual power-of-two steps, only due bodies are evaluated.
+                                // Pays off with DirectSolver and BarnesHutSolver only, FMM and PM evaluate everyone.
+        };
+
+        // What happens when the discs of two bodies with a radius overlap
+        enum class CollisionMode {
+            None,               // Bodies pass through each other
+            Merge               // Touching bodies become one, conserving mass and momentum
+        };
 
     private:
+        friend class Checkpoint;
+
+        BodyStorage storage;                        // Contiguous state of every body
+        std::vector<std::shared_ptr<Body>> bodies;  // Handles, bodies[i] views storage index i
+        std::shared_ptr<GravitySolver> solver;      // Algorithm used to evaluate gravity
+        std::unique_ptr<ThreadPool> pool;           // Threads used for force evaluation and integration
+        Integrator integrator = Integrator::SemiImplicitEuler;
+        bool accelerationsValid = false;            // Stored accelerations match the current positions
+        double simulationTime = 0.0;                // Sum of the steps taken so far
+        uint64_t stepCount = 0;                     // Calls to step so far
+        std::vector<std::shared_ptr<StepObserver>> observers;  // Notified after every step
+
+        // Collisions are resolved right before every force evaluation
+        CollisionMode collisionMode = CollisionMode::None;
+        std::unique_ptr<SpatialHash> broadPhase;
+        std::vector<std::pair<uint32_t, uint32_t>> collisionPairs;
+        std::vector<uint32_t> mergeRoot;            // Union-find parent of every body
+        std::vector<uint8_t> absorbed;              // Bodies merged into another one
+        size_t mergeCount = 0;
+
+        // Block time steps: body i advances by time / 2^levels[i]
+        int maxLevel = 10;                          // Finest level, steps down to time / 2^maxLevel
+        double timeStepAccuracy = 0.02;             // eta in dt = eta * |a| / |da/dt|
+        std::vector<uint8_t> levels;
+        std::vector<uint32_t> active;               // Bodies whose step ends at the current substep
+        std::vector<double> previousAx, previousAy; // Accelerations at the start of each body's step
+
+        void createHandles(size_t first);           // Handles for the bodies from storage index first on
         void calculateBodyAccelerations();
+        bool mergeCollisions();                     // Returns true if any bodies merged
+        void kick(double time);                     // v += a * time
+        void drift(double time);                    // x += v * time
+
+        void stepBlocks(double time);
+        void initializeLevels(double time);
+        int chooseLevel(size_t i, double jerk2, double time) const;
+        void kickActive(const double* time);        // v += a * time[level] for the active bodies
 
     public:
+        World();
+        ~World();
+
+        // Bodies keep a pointer to their world, so it cannot be copied or moved
+        World(const World&) = delete;
+        World& operator=(const World&) = delete;
+
         void addBody(std::shared_ptr<Body> body);
         std::shared_ptr<Body> getBody(int index);
         void removeBody(std::shared_ptr<Body> body);
 
+        // Append every body of states in one pass and return the handles' first index.
+        // Much faster than addBody for large scenarios, handles are created for each body.
+        size_t addBodies(const BodyStorage& states);
+
+        // Same, but an empty world takes the arrays of states over without copying them
+        size_t addBodies(BodyStorage&& states);
+
+        // Reserve storage for n bodies
+        void reserve(size_t n);
+
         size_t numBodies() const;
 
+        // Select the gravity algorithm, DirectSolver by default
+        void setSolver(std::shared_ptr<GravitySolver> solver);
+        std::shared_ptr<GravitySolver> getSolver() const;
+
+        // Number of threads used by step, 0 uses every hardware thread
+        void setThreadCount(size_t threads);
+        size_t getThreadCount() const;
+
+        // Threads of the world, for bulk work outside step such as generating bodies
+        ThreadPool& getThreadPool();
+
+        // Select the time integration scheme, SemiImplicitEuler by default
+        void setIntegrator(Integrator integrator);
+        Integrator getIntegrator() const;
+
+        // Block time step parameters: eta in dt = eta * |a| / |da/dt| and the finest level
+        void setTimeStepAccuracy(double eta);
+        double getTimeStepAccuracy() const;
+        void setMaxTimeStepLevel(int level);
+        int getMaxTimeStepLevel() const;
+
+        // Level of every body in the last block step, body i advanced by time / 2^level
+        const std::vector<uint8_t>& getTimeStepLevels() const;
+
+        // Force the next step to re-evaluate accelerations. Called automatically when
+        // bodies, positions, masses or the solver change; call it after reconfiguring a solver.
+        void invalidateAccelerations();
+
+        // Collision handling, CollisionMode::None by default. Only bodies with a radius collide.
+        void setCollisionMode(CollisionMode mode);
+        CollisionMode getCollisionMode() const;
+
+        // Bodies absorbed by mergers so far. Their handles are detached from the world.
+        size_t getMergeCount() const;
+
+        // Simulated time, advanced by every step
+        double getTime() const;
+        void setTime(double time);
+
+        // Steps taken so far, restored from checkpoints
+        uint64_t getStepCount() const;
+        void setStepCount(uint64_t steps);
+
+        // Observers are called in the order they were added, after every step
+        void addObserver(std::shared_ptr<StepObserver> observer);
+        void removeObserver(std::shared_ptr<StepObserver> observer);
+
+        // Read-only access to the body arrays
+        const BodyStorage& getStorage() const;
+
         void step(double time); // Orbit Mechanics
 
     };
 
 } // namespace Physics
 
-#endif // WORLD_HPP
\ No newline at end of file
+#endif // WORLD_HPP
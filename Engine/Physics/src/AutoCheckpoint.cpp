@@ -0,0 +1,49 @@
+#include <stdexcept>
+
+#include "../headers/AutoCheckpoint.hpp"
+#include "../headers/Checkpoint.hpp"
+
+namespace Physics {
+
+    AutoCheckpoint::AutoCheckpoint(const std::string& filename, size_t everySteps, double everySeconds)
+        : filename(filename), everySteps(everySteps), everySeconds(everySeconds), lastSave(std::chrono::steady_clock::now()) {
+        if (everySteps == 0 && everySeconds <= 0.0) {
+            throw std::invalid_argument("AutoCheckpoint needs a step or time interval");
+        }
+    }
+
+    AutoCheckpoint::~AutoCheckpoint() {
+        // Finish the last write, errors cannot leave a destructor
+        if (pending.valid()) pending.wait();
+    }
+
+    void AutoCheckpoint::onStep(const World& world) {
+        stepsSinceSave++;
+
+        bool due = everySteps && stepsSinceSave >= everySteps;
+        if (!due && everySeconds > 0.0) {
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - lastSave;
+            due = elapsed.count() >= everySeconds;
+        }
+        if (!due) return;
+
+        if (pending.valid()) {
+            // Previous write still running, try again next step
+            if (pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+            pending.get();
+        }
+
+        pending = Checkpoint::saveAsync(world, filename);
+        stepsSinceSave = 0;
+        lastSave = std::chrono::steady_clock::now();
+        saved++;
+    }
+
+    void AutoCheckpoint::flush() {
+        if (pending.valid()) pending.get();
+    }
+
+    size_t AutoCheckpoint::getSaveCount() const { return saved; }
+    const std::string& AutoCheckpoint::getFilename() const { return filename; }
+
+} // namespace Physics
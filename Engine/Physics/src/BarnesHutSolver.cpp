@@ -0,0 +1,248 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "../headers/BarnesHutSolver.hpp"
+#include "../headers/BodyStorage.hpp"
+#include "../headers/ThreadPool.hpp"
+#include "../headers/Constants.hpp"
+
+namespace Physics {
+
+    // Cells are not split below this depth, so coincident bodies end up in one leaf
+    static constexpr int MaxDepth = 48;
+
+    BarnesHutSolver::BarnesHutSolver(double theta, double softening, bool useQuadrupole, size_t leafSize)
+        : theta(theta), softening(softening), useQuadrupole(useQuadrupole), leafSize(std::max<size_t>(leafSize, 1)) {
+    }
+
+    void BarnesHutSolver::setTheta(double theta) { this->theta = theta; }
+    double BarnesHutSolver::getTheta() const { return theta; }
+
+    void BarnesHutSolver::setSoftening(double softening) { this->softening = softening; }
+    double BarnesHutSolver::getSoftening() const { return softening; }
+
+    void BarnesHutSolver::setQuadrupole(bool enabled) { useQuadrupole = enabled; }
+    bool BarnesHutSolver::quadrupoleEnabled() const { return useQuadrupole; }
+
+    const std::vector<BarnesHutSolver::Node>& BarnesHutSolver::getNodes() const { return nodes; }
+
+    void BarnesHutSolver::build(const BodyStorage& storage) {
+        const size_t n = storage.size();
+        nodes.clear();
+        order.resize(n);
+        std::iota(order.begin(), order.end(), 0u);
+        if (n == 0) return;
+
+        // Square root cell enclosing every body
+        const double* x = storage.x.data();
+        const double* y = storage.y.data();
+        double minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+        for (size_t i = 1; i < n; i++) {
+            minX = std::min(minX, x[i]); maxX = std::max(maxX, x[i]);
+            minY = std::min(minY, y[i]); maxY = std::max(maxY, y[i]);
+        }
+
+        Node root{};
+        root.centerX = 0.5 * (minX + maxX);
+        root.centerY = 0.5 * (minY + maxY);
+        root.halfSize = 0.5 * std::max(maxX - minX, maxY - minY) * (1.0 + 1e-12);
+        root.begin = 0;
+        root.end = static_cast<uint32_t>(n);
+
+        nodes.reserve(2 * n / leafSize + 16);
+        nodes.push_back(root);
+        buildNode(0, x, y, storage.mass.data(), 0);
+    }
+
+    void BarnesHutSolver::buildNode(uint32_t node, const double* x, const double* y, const double* mass, int depth) {
+        Node& cell = nodes[node];
+        cell.firstChild = NoChild;
+
+        if (cell.end - cell.begin > leafSize && depth < MaxDepth) {
+            const double cx = cell.centerX, cy = cell.centerY, quarter = 0.5 * cell.halfSize;
+            uint32_t* first = order.data() + cell.begin;
+            uint32_t* last = order.data() + cell.end;
+
+            // Group the bodies by quadrant: (x < cx, y < cy), (x >= cx, y < cy), (x < cx, y >= cy), (x >= cx, y >= cy)
+            uint32_t* midY = std::partition(first, last, [&](uint32_t i) { return y[i] < cy; });
+            uint32_t* lowerX = std::partition(first, midY, [&](uint32_t i) { return x[i] < cx; });
+            uint32_t* upperX = std::partition(midY, last, [&](uint32_t i) { return x[i] < cx; });
+
+            const uint32_t bounds[5] = {
+                cell.begin,
+                static_cast<uint32_t>(lowerX - order.data()),
+                static_cast<uint32_t>(midY - order.data()),
+                static_cast<uint32_t>(upperX - order.data()),
+                cell.end
+            };
+
+            const uint32_t firstChild = static_cast<uint32_t>(nodes.size());
+            cell.firstChild = firstChild;
+
+            // The push_backs may reallocate, so cell is not used past this point
+            for (int q = 0; q < 4; q++) {
+                Node child{};
+                child.centerX = cx + ((q & 1) ? quarter : -quarter);
+                child.centerY = cy + ((q & 2) ? quarter : -quarter);
+                child.halfSize = quarter;
+                child.begin = bounds[q];
+                child.end = bounds[q + 1];
+                nodes.push_back(child);
+            }
+
+            for (uint32_t q = 0; q < 4; q++) {
+                buildNode(firstChild + q, x, y, mass, depth + 1);
+            }
+
+            // Combine the children's moments, shifting each quadrupole to the parent's center of mass
+            Node& parent = nodes[node];
+            double m = 0.0, mx = 0.0, my = 0.0;
+            for (uint32_t q = 0; q < 4; q++) {
+                const Node& child = nodes[firstChild + q];
+                m += child.mass;
+                mx += child.mass * child.comX;
+                my += child.mass * child.comY;
+            }
+            parent.mass = m;
+            parent.comX = m > 0.0 ? mx / m : parent.centerX;
+            parent.comY = m > 0.0 ? my / m : parent.centerY;
+
+            parent.qxx = parent.qxy = parent.qyy = 0.0;
+            for (uint32_t q = 0; q < 4; q++) {
+                const Node& child = nodes[firstChild + q];
+                double dx = child.comX - parent.comX;
+                double dy = child.comY - parent.comY;
+                double d2 = dx * dx + dy * dy;
+                parent.qxx += child.qxx + child.mass * (3.0 * dx * dx - d2);
+                parent.qxy += child.qxy + child.mass * (3.0 * dx * dy);
+                parent.qyy += child.qyy + child.mass * (3.0 * dy * dy - d2);
+            }
+            return;
+        }
+
+        // Leaf: moments straight from its bodies
+        double m = 0.0, mx = 0.0, my = 0.0;
+        for (uint32_t k = cell.begin; k < cell.end; k++) {
+            uint32_t i = order[k];
+            m += mass[i];
+            mx += mass[i] * x[i];
+            my += mass[i] * y[i];
+        }
+        cell.mass = m;
+        cell.comX = m > 0.0 ? mx / m : cell.centerX;
+        cell.comY = m > 0.0 ? my / m : cell.centerY;
+
+        cell.qxx = cell.qxy = cell.qyy = 0.0;
+        for (uint32_t k = cell.begin; k < cell.end; k++) {
+            uint32_t i = order[k];
+            double dx = x[i] - cell.comX;
+            double dy = y[i] - cell.comY;
+            double d2 = dx * dx + dy * dy;
+            cell.qxx += mass[i] * (3.0 * dx * dx - d2);
+            cell.qxy += mass[i] * (3.0 * dx * dy);
+            cell.qyy += mass[i] * (3.0 * dy * dy - d2);
+        }
+    }
+
+    void BarnesHutSolver::accelerationOf(const BodyStorage& storage, size_t index, double& ax, double& ay) const {
+        ax = ay = 0.0;
+        if (nodes.empty()) return;
+
+        const double* x = storage.x.data();
+        const double* y = storage.y.data();
+        const double* mass = storage.mass.data();
+        const double px = x[index], py = y[index];
+        const double eps2 = softening * softening;
+        const double theta2 = theta * theta;
+
+        uint32_t stack[4 * MaxDepth + 4];
+        int top = 0;
+        stack[top++] = 0;
+
+        double accelerationX = 0.0, accelerationY = 0.0;
+
+        while (top > 0) {
+            const Node& cell = nodes[stack[--top]];
+            if (cell.begin == cell.end) continue;
+
+            if (cell.firstChild == NoChild) {
+                // Leaf: sum its bodies directly
+                for (uint32_t k = cell.begin; k < cell.end; k++) {
+                    uint32_t j = order[k];
+                    if (j == index) continue;
+
+                    double dx = x[j] - px;
+                    double dy = y[j] - py;
+                    double r2 = dx * dx + dy * dy + eps2;
+                    if (r2 <= 0.0) continue; // Coincident bodies share a leaf, skip their pair
+                    double rInv = 1.0 / std::sqrt(r2);
+                    double s = mass[j] * rInv * rInv * rInv;
+                    accelerationX += dx * s;
+                    accelerationY += dy * s;
+                }
+                continue;
+            }
+
+            // Vector from the cell's center of mass to the body
+            double rx = px - cell.comX;
+            double ry = py - cell.comY;
+            double r2 = rx * rx + ry * ry;
+            double size = 2.0 * cell.halfSize;
+
+            bool inside = std::abs(px - cell.centerX) <= cell.halfSize && std::abs(py - cell.centerY) <= cell.halfSize;
+
+            if (inside || size * size >= theta2 * r2) {
+                // Too close, open the cell
+                for (uint32_t q = 0; q < 4; q++) stack[top++] = cell.firstChild + q;
+                continue;
+            }
+
+            // Monopole: -M r / r^3
+            double rInv = 1.0 / std::sqrt(r2 + eps2);
+            double rInv2 = rInv * rInv;
+            double rInv3 = rInv * rInv2;
+            accelerationX -= cell.mass * rx * rInv3;
+            accelerationY -= cell.mass * ry * rInv3;
+
+            if (useQuadrupole) {
+                // Quadrupole: Q r / r^5 - 5/2 (r.Q.r) r / r^7
+                double qrx = cell.qxx * rx + cell.qxy * ry;
+                double qry = cell.qxy * rx + cell.qyy * ry;
+                double rqr = rx * qrx + ry * qry;
+                double rInv5 = rInv3 * rInv2;
+                double rInv7 = rInv5 * rInv2;
+                accelerationX += qrx * rInv5 - 2.5 * rqr * rx * rInv7;
+                accelerationY += qry * rInv5 - 2.5 * rqr * ry * rInv7;
+            }
+        }
+
+        ax = Constants::GRAVITATIONAL_CONSTANT * accelerationX;
+        ay = Constants::GRAVITATIONAL_CONSTANT * accelerationY;
+    }
+
+    void BarnesHutSolver::computeAccelerations(BodyStorage& storage, ThreadPool& pool) {
+        build(storage);
+
+        // Walk bodies in tree order so neighbouring walks share cache lines.
+        // Each body is written by exactly one task.
+        pool.parallelFor(order.size(), 256, [&](size_t begin, size_t end, size_t) {
+            for (size_t k = begin; k < end; k++) {
+                uint32_t i = order[k];
+                accelerationOf(storage, i, storage.ax[i], storage.ay[i]);
+            }
+        });
+    }
+
+    void BarnesHutSolver::computeActiveAccelerations(BodyStorage& storage, const std::vector<uint32_t>& active, ThreadPool& pool) {
+        build(storage);
+
+        pool.parallelFor(active.size(), 64, [&](size_t begin, size_t end, size_t) {
+            for (size_t k = begin; k < end; k++) {
+                uint32_t i = active[k];
+                accelerationOf(storage, i, storage.ax[i], storage.ay[i]);
+            }
+        });
+    }
+
+} // namespace Physics
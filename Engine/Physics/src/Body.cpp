@@ -4,6 +4,7 @@
 
 // Physics Headers
 #include "../headers/Body.hpp"
+#include "../headers/World.hpp"
 #include "../headers/Property.hpp"
 
 // Math Headers
@@ -12,80 +13,166 @@
 #include "../../Math/headers/Constants.hpp"
 
 
-// #include "../headers/Transformation.hpp"
-// #include "../headers/Vector.hpp"
-// #include "../headers/FlatTransformation.hpp"
-// #include "../headers/FlatWorld.hpp"
-// #include "../headers/FlatMath.hpp"
-// #include "../headers/FlatAABB.hpp"
-
 namespace Physics {
 
 
     Body::Body(double mass, const Math::Vector& position)
     {
-        // Add Kinematic Properties
-        kinematicProperties[KinematicProperty::Position] = position;
-        kinematicProperties[KinematicProperty::LinearVelocity] = Math::Vector(0, 0);
-        kinematicProperties[KinematicProperty::Force] = Math::Vector(0, 0);
-
-        // Add Physical Properties
-        physicalProperties[PhysicalProperty::Mass] = mass;
-        physicalProperties[PhysicalProperty::InverseMass] = 1.0 / mass;
+        // Kinematic Properties
+        state.x = position.x;
+        state.y = position.y;
+
+        // Physical Properties
+        state.mass = mass;
+        state.invMass = 1.0 / mass;
+    }
+
+    // Locate a Physical Property, either in the world's storage or locally
+    double* Body::physical(PhysicalProperty property) {
+        return const_cast<double*>(static_cast<const Body*>(this)->physical(property));
+    }
+
+    const double* Body::physical(PhysicalProperty property) const {
+        const BodyStorage* storage = world ? &world->getStorage() : nullptr;
+
+        switch (property) {
+        case PhysicalProperty::Mass:
+            return storage ? &storage->mass[index] : &state.mass;
+        case PhysicalProperty::InverseMass:
+            return storage ? &storage->invMass[index] : &state.invMass;
+        case PhysicalProperty::Radius:
+            return storage ? &storage->radius[index] : &state.radius;
+        }
+        return nullptr;
+    }
+
+    // Locate a Kinematic Property, either in the world's storage or locally
+    void Body::kinematic(KinematicProperty property, double*& x, double*& y) {
+        const double* cx;
+        const double* cy;
+        static_cast<const Body*>(this)->kinematic(property, cx, cy);
+        x = const_cast<double*>(cx);
+        y = const_cast<double*>(cy);
+    }
+
+    void Body::kinematic(KinematicProperty property, const double*& x, const double*& y) const {
+        const BodyStorage* storage = world ? &world->getStorage() : nullptr;
+        x = y = nullptr;
+
+        switch (property) {
+        case KinematicProperty::Position:
+            x = storage ? &storage->x[index] : &state.x;
+            y = storage ? &storage->y[index] : &state.y;
+            break;
+        case KinematicProperty::LinearVelocity:
+            x = storage ? &storage->vx[index] : &state.vx;
+            y = storage ? &storage->vy[index] : &state.vy;
+            break;
+        case KinematicProperty::Force:
+            x = storage ? &storage->fx[index] : &state.fx;
+            y = storage ? &storage->fy[index] : &state.fy;
+            break;
+        case KinematicProperty::Acceleration:
+            x = storage ? &storage->ax[index] : &state.ax;
+            y = storage ? &storage->ay[index] : &state.ay;
+            break;
+        }
     }
 
     // Set Physical Property
     void Body::setPhysicalProperty(PhysicalProperty property, double value) {
-        physicalProperties[property] = value;
+        double* p = physical(property);
+        if (!p) throw std::runtime_error("Physical Property does not exist");
+        *p = value;
+
+        // Gravity depends on the masses
+        if (world && property != PhysicalProperty::Radius) world->invalidateAccelerations();
     }
 
     void Body::addPhysicalProperty(PhysicalProperty property, double value) {
-        physicalProperties[property] += value;
+        double* p = physical(property);
+        if (!p) throw std::runtime_error("Physical Property does not exist");
+        *p += value;
+
+        // Gravity depends on the masses
+        if (world && property != PhysicalProperty::Radius) world->invalidateAccelerations();
     }
 
     // Check if Physical Property exists
     bool Body::physicalPropertyExists(PhysicalProperty property) const {
-        return physicalProperties.find(property) != physicalProperties.end();
+        return physical(property) != nullptr;
     }
 
     // Get Physical Property
     double Body::getPhysicalProperty(PhysicalProperty property) const {
-        if (physicalPropertyExists(property)) {
-            return physicalProperties.at(property);
+        const double* p = physical(property);
+        if (p) {
+            return *p;
         }
         throw std::runtime_error("Physical Property does not exist");
     }
 
     // Set Kinematic Property
     void Body::setKinematicProperty(KinematicProperty property, const Math::Vector& value) {
-        kinematicProperties[property] = value;
+        double* x;
+        double* y;
+        kinematic(property, x, y);
+        if (!x) throw std::runtime_error("Kinematic Property does not exist");
+        *x = value.x;
+        *y = value.y;
+
+        // Gravity depends on the positions
+        if (world && property == KinematicProperty::Position) world->invalidateAccelerations();
     }
 
     void Body::addKinematicProperty(KinematicProperty property, const Math::Vector& value) {
-        kinematicProperties[property] += value;
+        double* x;
+        double* y;
+        kinematic(property, x, y);
+        if (!x) throw std::runtime_error("Kinematic Property does not exist");
+        *x += value.x;
+        *y += value.y;
+
+        // Gravity depends on the positions
+        if (world && property == KinematicProperty::Position) world->invalidateAccelerations();
     }
 
     // Check if Kinematic Property exists
     bool Body::kinematicPropertyExists(KinematicProperty property) const {
-        return kinematicProperties.find(property) != kinematicProperties.end();
+        const double* x;
+        const double* y;
+        kinematic(property, x, y);
+        return x != nullptr;
     }
 
     // Get Kinematic Property
     Math::Vector Body::getKinematicProperty(KinematicProperty property) const {
-        if (kinematicPropertyExists(property)) {
-            return kinematicProperties.at(property);
+        const double* x;
+        const double* y;
+        kinematic(property, x, y);
+        if (x) {
+            return Math::Vector(*x, *y);
         }
         throw std::runtime_error("Kinematic Property does not exist");
     }
 
     void Body::step(double time) {
+        double* px; double* py;
+        double* vx; double* vy;
+        double* ax; double* ay;
+        kinematic(KinematicProperty::Position, px, py);
+        kinematic(KinematicProperty::LinearVelocity, vx, vy);
+        kinematic(KinematicProperty::Acceleration, ax, ay);
+
         // Update linear velocity
-        kinematicProperties[KinematicProperty::LinearVelocity] +=
-            kinematicProperties[KinematicProperty::Acceleration] * time;
+        *vx += *ax * time;
+        *vy += *ay * time;
 
         // Update position
-        kinematicProperties[KinematicProperty::Position] +=
-            kinematicProperties[KinematicProperty::LinearVelocity] * time;
+        *px += *vx * time;
+        *py += *vy * time;
+
+        if (world) world->invalidateAccelerations();
     }
 
-} // namespace Physics
\ No newline at end of file
+} // namespace Physics
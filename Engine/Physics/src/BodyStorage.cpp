@@ -0,0 +1,92 @@
+#include "../headers/BodyStorage.hpp"
+
+namespace Physics {
+
+    size_t BodyStorage::size() const {
+        return mass.size();
+    }
+
+    void BodyStorage::reserve(size_t n) {
+        x.reserve(n); y.reserve(n);
+        vx.reserve(n); vy.reserve(n);
+        fx.reserve(n); fy.reserve(n);
+        ax.reserve(n); ay.reserve(n);
+        mass.reserve(n);
+        invMass.reserve(n);
+        radius.reserve(n);
+    }
+
+    void BodyStorage::resize(size_t n) {
+        x.resize(n); y.resize(n);
+        vx.resize(n); vy.resize(n);
+        fx.resize(n); fy.resize(n);
+        ax.resize(n); ay.resize(n);
+        mass.resize(n);
+        invMass.resize(n);
+        radius.resize(n);
+    }
+
+    void BodyStorage::push(const BodyState& state) {
+        x.push_back(state.x); y.push_back(state.y);
+        vx.push_back(state.vx); vy.push_back(state.vy);
+        fx.push_back(state.fx); fy.push_back(state.fy);
+        ax.push_back(state.ax); ay.push_back(state.ay);
+        mass.push_back(state.mass);
+        invMass.push_back(state.invMass);
+        radius.push_back(state.radius);
+    }
+
+    void BodyStorage::erase(size_t index) {
+        x.erase(x.begin() + index); y.erase(y.begin() + index);
+        vx.erase(vx.begin() + index); vy.erase(vy.begin() + index);
+        fx.erase(fx.begin() + index); fy.erase(fy.begin() + index);
+        ax.erase(ax.begin() + index); ay.erase(ay.begin() + index);
+        mass.erase(mass.begin() + index);
+        invMass.erase(invMass.begin() + index);
+        radius.erase(radius.begin() + index);
+    }
+
+    void BodyStorage::compact(const std::vector<uint8_t>& remove) {
+        std::vector<double>* arrays[] = { &x, &y, &vx, &vy, &fx, &fy, &ax, &ay, &mass, &invMass, &radius };
+        for (std::vector<double>* array : arrays) {
+            size_t kept = 0;
+            for (size_t i = 0; i < array->size(); i++) {
+                if (!remove[i]) (*array)[kept++] = (*array)[i];
+            }
+            array->resize(kept);
+        }
+    }
+
+    void BodyStorage::clear() {
+        x.clear(); y.clear();
+        vx.clear(); vy.clear();
+        fx.clear(); fy.clear();
+        ax.clear(); ay.clear();
+        mass.clear();
+        invMass.clear();
+        radius.clear();
+    }
+
+    BodyState BodyStorage::load(size_t index) const {
+        BodyState state;
+        state.x = x[index]; state.y = y[index];
+        state.vx = vx[index]; state.vy = vy[index];
+        state.fx = fx[index]; state.fy = fy[index];
+        state.ax = ax[index]; state.ay = ay[index];
+        state.mass = mass[index];
+        state.invMass = invMass[index];
+        state.radius = radius[index];
+        return state;
+    }
+
+    void BodyStorage::store(size_t index, const BodyState& state) {
+        x[index] = state.x; y[index] = state.y;
+        vx[index] = state.vx; vy[index] = state.vy;
+        fx[index] = state.fx; fy[index] = state.fy;
+        ax[index] = state.ax; ay[index] = state.ay;
+        mass[index] = state.mass;
+        invMass[index] = state.invMass;
+        radius[index] = state.radius;
+    }
+
+} // namespace Physics
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../headers/BodyTree.hpp"
+
+#include "../../Math/headers/BoundingBox.hpp"
+
+namespace Physics {
+
+    BodyTree::BodyTree(double margin) : tree(margin) {}
+
+    uint32_t BodyTree::bodyOf(int32_t proxy) const {
+        return tree.getUserData(proxy);
+    }
+
+    size_t BodyTree::update(const BodyStorage& storage, double lookAheadTime) {
+        this->storage = &storage;
+        const size_t n = storage.size();
+
+        if (proxies.size() != n) {
+            tree.clear();
+            proxies.resize(n);
+            for (size_t i = 0; i < n; i++) {
+                const Math::BoundingBox box = Math::BoundingBox::Around(Math::Vector(storage.x[i], storage.y[i]), storage.radius[i]);
+                proxies[i] = tree.insert(box, static_cast<uint32_t>(i));
+            }
+            return n;
+        }
+
+        size_t reinserted = 0;
+        for (size_t i = 0; i < n; i++) {
+            const Math::BoundingBox box = Math::BoundingBox::Around(Math::Vector(storage.x[i], storage.y[i]), storage.radius[i]);
+            const Math::Vector displacement(storage.vx[i] * lookAheadTime, storage.vy[i] * lookAheadTime);
+            if (tree.move(proxies[i], box, displacement)) reinserted++;
+        }
+        return reinserted;
+    }
+
+    void BodyTree::clear() {
+        tree.clear();
+        proxies.clear();
+        storage = nullptr;
+    }
+
+    size_t BodyTree::pick(const Math::Vector& point, double tolerance) const {
+        size_t best = None;
+        double bestDistance = std::numeric_limits<double>::infinity();
+
+        tree.queryRadius(point, tolerance, [&](int32_t proxy) {
+            const uint32_t i = bodyOf(proxy);
+            const double dx = storage->x[i] - point.x;
+            const double dy = storage->y[i] - point.y;
+            const double distance = std::sqrt(dx * dx + dy * dy);
+            if (distance <= storage->radius[i] + tolerance && distance < bestDistance) {
+                best = i;
+                bestDistance = distance;
+            }
+            return true;
+        });
+        return best;
+    }
+
+    void BodyTree::queryRadius(const Math::Vector& center, double radius, std::vector<size_t>& bodies) const {
+        bodies.clear();
+        tree.queryRadius(center, radius, [&](int32_t proxy) {
+            const uint32_t i = bodyOf(proxy);
+            const double dx = storage->x[i] - center.x;
+            const double dy = storage->y[i] - center.y;
+            const double reach = storage->radius[i] + radius;
+            if (dx * dx + dy * dy <= reach * reach) bodies.push_back(i);
+            return true;
+        });
+        std::sort(bodies.begin(), bodies.end());
+    }
+
+    bool BodyTree::raycast(const Math::Vector& origin, const Math::Vector& direction, double maxT, size_t& index, double& t) const {
+        const double a = direction.x * direction.x + direction.y * direction.y;
+        if (!(a > 0.0)) return false;
+
+        bool hit = false;
+        tree.raycast(origin, direction, maxT, [&](int32_t proxy, double) {
+            // Smallest root of |origin + t * direction - center|^2 = r^2, 0 if the origin is inside
+            const uint32_t i = bodyOf(proxy);
+            const double fx = origin.x - storage->x[i];
+            const double fy = origin.y - storage->y[i];
+            const double b = fx * direction.x + fy * direction.y;
+            const double c = fx * fx + fy * fy - storage->radius[i] * storage->radius[i];
+            const double discriminant = b * b - a * c;
+            if (discriminant < 0.0) return maxT;
+
+            const double entry = c <= 0.0 ? 0.0 : (-b - std::sqrt(discriminant)) / a;
+            if (entry < 0.0 || entry > maxT) return maxT;
+
+            hit = true;
+            index = i;
+            t = entry;
+            maxT = entry;
+            return maxT;
+        });
+        return hit;
+    }
+
+    void BodyTree::findPairs(std::vector<Pair>& pairs) const {
+        pairs.clear();
+        tree.queryPairs([&](int32_t proxyA, int32_t proxyB) {
+            const uint32_t i = bodyOf(proxyA), j = bodyOf(proxyB);
+            if (storage->radius[i] <= 0.0 || storage->radius[j] <= 0.0) return;
+            const double dx = storage->x[j] - storage->x[i];
+            const double dy = storage->y[j] - storage->y[i];
+            const double reach = storage->radius[i] + storage->radius[j];
+            if (dx * dx + dy * dy < reach * reach) pairs.emplace_back(std::min(i, j), std::max(i, j));
+        });
+        std::sort(pairs.begin(), pairs.end());
+    }
+
+    const Math::AABBTree& BodyTree::getTree() const {
+        return tree;
+    }
+
+} // namespace Physics
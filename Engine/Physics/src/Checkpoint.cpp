@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../headers/Checkpoint.hpp"
+#include "../headers/World.hpp"
+#include "../headers/BodyStorage.hpp"
+
+namespace Physics {
+
+    static_assert(sizeof(Checkpoint::Header) == 64, "Checkpoint header must stay 64 bytes");
+
+    static constexpr char Magic[8] = { 'P', 'H', 'Y', 'S', 'C', 'K', 'P', 'T' };
+
+    // Host byte order, checked at run time since std::endian needs C++20
+    static bool isLittleEndian() {
+        const uint16_t one = 1;
+        unsigned char first;
+        std::memcpy(&first, &one, 1);
+        return first == 1;
+    }
+
+    static const bool LittleEndian = isLittleEndian();
+
+    template <typename T>
+    static T swapBytes(T value) {
+        unsigned char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        std::reverse(bytes, bytes + sizeof(T));
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+
+    // Convert between host and file byte order, a no-op on little-endian hosts
+    template <typename T>
+    static T littleEndian(T value) {
+        return LittleEndian ? value : swapBytes(value);
+    }
+
+    static Checkpoint::Header convertHeader(Checkpoint::Header header) {
+        header.version = littleEndian(header.version);
+        header.headerSize = littleEndian(header.headerSize);
+        header.bodyCount = littleEndian(header.bodyCount);
+        header.time = littleEndian(header.time);
+        header.integrator = littleEndian(header.integrator);
+        header.flags = littleEndian(header.flags);
+        header.stepCount = littleEndian(header.stepCount);
+        return header;
+    }
+
+    // State copied out of a world, ready to be written without touching the world again
+    struct Snapshot {
+        Checkpoint::Header header;
+        std::vector<double> arrays;     // ArrayCount arrays of bodyCount values, file byte order
+    };
+
+    static void writeSnapshot(const Snapshot& snapshot, const std::string& filename) {
+        const std::string temporary = filename + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file.is_open()) {
+                throw std::runtime_error("Unable to write checkpoint " + temporary);
+            }
+
+            Checkpoint::Header header = convertHeader(snapshot.header);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(snapshot.arrays.data()), snapshot.arrays.size() * sizeof(double));
+            file.flush();
+
+            if (!file) {
+                throw std::runtime_error("Failed writing checkpoint " + temporary);
+            }
+        }
+
+        // Replace the previous checkpoint only once the new one is complete
+        std::error_code error;
+        std::filesystem::rename(temporary, filename, error);
+        if (error) {
+            throw std::runtime_error("Unable to replace checkpoint " + filename + ": " + error.message());
+        }
+    }
+
+    static Snapshot takeSnapshot(const World& world, bool accelerationsValid, World::Integrator integrator) {
+        const BodyStorage& storage = world.getStorage();
+        const size_t n = storage.size();
+
+        Snapshot snapshot;
+        std::memset(&snapshot.header, 0, sizeof(snapshot.header));
+        std::memcpy(snapshot.header.magic, Magic, sizeof(Magic));
+        snapshot.header.version = Checkpoint::Version;
+        snapshot.header.headerSize = sizeof(Checkpoint::Header);
+        snapshot.header.bodyCount = n;
+        snapshot.header.time = world.getTime();
+        snapshot.header.integrator = static_cast<uint32_t>(integrator);
+        snapshot.header.flags = accelerationsValid ? Checkpoint::AccelerationsValid : 0;
+        snapshot.header.stepCount = world.getStepCount();
+
+        const std::vector<double>* arrays[Checkpoint::ArrayCount] = {
+            &storage.x, &storage.y, &storage.vx, &storage.vy, &storage.ax, &storage.ay, &storage.mass, &storage.radius
+        };
+
+        snapshot.arrays.resize(Checkpoint::ArrayCount * n);
+        for (size_t a = 0; a < Checkpoint::ArrayCount; a++) {
+            double* target = snapshot.arrays.data() + a * n;
+            if (n) std::memcpy(target, arrays[a]->data(), n * sizeof(double));
+            if (!LittleEndian) {
+                for (size_t i = 0; i < n; i++) target[i] = swapBytes(target[i]);
+            }
+        }
+        return snapshot;
+    }
+
+    Checkpoint::Checkpoint(const std::string& filename) : mapped(filename) {
+        // Validate before exposing any array
+        const unsigned char* data = mapped.begin();
+        const size_t length = mapped.size();
+        if (length < sizeof(Header)) {
+            throw std::runtime_error("Checkpoint " + filename + " is too short");
+        }
+
+        std::memcpy(&header, data, sizeof(Header));
+        header = convertHeader(header);
+
+        std::string problem;
+        if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) problem = "is not a checkpoint";
+        else if (header.version == 0 || header.version > Version) problem = "has unsupported version " + std::to_string(header.version);
+        else if (header.headerSize < sizeof(Header) || header.headerSize % sizeof(double) != 0 || header.headerSize > length) problem = "has a corrupt header";
+        // Checked by division so a huge bodyCount cannot overflow; passing it bounds arrayCount() * bodyCount by the file length
+        else if (header.bodyCount > (length - header.headerSize) / (arrayCount() * sizeof(double))) problem = "is truncated";
+
+        if (!problem.empty()) {
+            throw std::runtime_error("Checkpoint " + filename + " " + problem);
+        }
+
+        if (!LittleEndian) {
+            const size_t count = arrayCount() * header.bodyCount;
+            converted.resize(count);
+            std::memcpy(converted.data(), data + header.headerSize, count * sizeof(double));
+            for (double& value : converted) value = swapBytes(value);
+        }
+    }
+
+    const double* Checkpoint::array(size_t index) const {
+        if (!LittleEndian) return converted.data() + index * header.bodyCount;
+        return reinterpret_cast<const double*>(mapped.begin() + header.headerSize) + index * header.bodyCount;
+    }
+
+    size_t Checkpoint::size() const { return static_cast<size_t>(header.bodyCount); }
+    double Checkpoint::getTime() const { return header.time; }
+    const Checkpoint::Header& Checkpoint::getHeader() const { return header; }
+
+    const double* Checkpoint::x() const { return array(0); }
+    const double* Checkpoint::y() const { return array(1); }
+    const double* Checkpoint::vx() const { return array(2); }
+    const double* Checkpoint::vy() const { return array(3); }
+    const double* Checkpoint::ax() const { return array(4); }
+    const double* Checkpoint::ay() const { return array(5); }
+    const double* Checkpoint::mass() const { return array(6); }
+    const double* Checkpoint::radius() const { return arrayCount() > 7 ? array(7) : nullptr; }
+
+    bool Checkpoint::hasStepCount() const {
+        return header.version >= 2;
+    }
+
+    size_t Checkpoint::arrayCount() const {
+        // Version 1 had no radius
+        return header.version == 1 ? 7 : ArrayCount;
+    }
+
+    void Checkpoint::restore(World& world) const {
+        if (world.numBodies() != 0) {
+            throw std::runtime_error("A checkpoint can only be restored into an empty World");
+        }
+
+        // Load the arrays into a storage and move it into the world, so they are copied once
+        const size_t n = size();
+        BodyStorage states;
+        states.x.assign(x(), x() + n);
+        states.y.assign(y(), y() + n);
+        states.vx.assign(vx(), vx() + n);
+        states.vy.assign(vy(), vy() + n);
+        states.fx.assign(n, 0.0);
+        states.fy.assign(n, 0.0);
+        states.ax.assign(ax(), ax() + n);
+        states.ay.assign(ay(), ay() + n);
+        states.mass.assign(mass(), mass() + n);
+        states.invMass.resize(n);
+        for (size_t i = 0; i < n; i++) states.invMass[i] = 1.0 / states.mass[i];
+        if (radius()) states.radius.assign(radius(), radius() + n);
+        else states.radius.assign(n, 0.0);
+
+        world.addBodies(std::move(states));
+
+        world.simulationTime = header.time;
+        world.stepCount = hasStepCount() ? header.stepCount : 0;
+        if (header.integrator <= static_cast<uint32_t>(World::Integrator::BlockLeapfrog)) {
+            world.integrator = static_cast<World::Integrator>(header.integrator);
+        }
+        world.accelerationsValid = (header.flags & AccelerationsValid) != 0;
+    }
+
+    void Checkpoint::save(const World& world, const std::string& filename) {
+        writeSnapshot(takeSnapshot(world, world.accelerationsValid, world.integrator), filename);
+    }
+
+    std::future<void> Checkpoint::saveAsync(const World& world, const std::string& filename) {
+        auto snapshot = std::make_shared<Snapshot>(takeSnapshot(world, world.accelerationsValid, world.integrator));
+        return std::async(std::launch::async, [snapshot, filename]() {
+            writeSnapshot(*snapshot, filename);
+        });
+    }
+
+} // namespace Physics
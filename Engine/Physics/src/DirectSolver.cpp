@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <cmath>
+
+#include "../headers/DirectSolver.hpp"
+#include "../headers/BodyStorage.hpp"
+#include "../headers/ThreadPool.hpp"
+#include "../headers/Constants.hpp"
+
+namespace Physics {
+
+    DirectSolver::DirectSolver(double softening) : softening(softening), kernel(GravityKernel::detect()) {}
+
+    void DirectSolver::setSoftening(double softening) { this->softening = softening; }
+    double DirectSolver::getSoftening() const { return softening; }
+
+    void DirectSolver::setKernel(GravityKernel::Isa kernel) {
+        this->kernel = GravityKernel::supported(kernel) ? kernel : GravityKernel::Isa::Scalar;
+    }
+
+    GravityKernel::Isa DirectSolver::getKernel() const { return kernel; }
+
+    void DirectSolver::setSymmetric(bool enabled) { symmetric = enabled; }
+    bool DirectSolver::isSymmetric() const { return symmetric; }
+
+    void DirectSolver::setPrecision(Precision precision) { this->precision = precision; }
+    DirectSolver::Precision DirectSolver::getPrecision() const { return precision; }
+
+    void DirectSolver::computeAccelerations(BodyStorage& storage, ThreadPool& pool) {
+        if (precision == Precision::Mixed) {
+            computeMixed(storage, nullptr, pool);
+            return;
+        }
+        if (symmetric) {
+            computeSymmetric(storage, pool);
+            return;
+        }
+
+        const size_t n = storage.size();
+        const double* x = storage.x.data();
+        const double* y = storage.y.data();
+        const double* mass = storage.mass.data();
+        double* ax = storage.ax.data();
+        double* ay = storage.ay.data();
+
+        const GravityKernel::Function accumulate = GravityKernel::get(kernel);
+        const double eps2 = softening * softening;
+
+        pool.parallelFor(n, TileSize, [&](size_t begin, size_t end, size_t) {
+            double sumX[TileSize] = {};
+            double sumY[TileSize] = {};
+
+            // Sources are always visited in the same blocks, so tiling does not change the result
+            for (size_t blockBegin = 0; blockBegin < n; blockBegin += BlockSize) {
+                const size_t blockEnd = std::min(blockBegin + BlockSize, n);
+                accumulate(x, y, mass, begin, end, blockBegin, blockEnd, eps2, sumX, sumY);
+            }
+
+            for (size_t i = begin; i < end; i++) {
+                ax[i] = Constants::GRAVITATIONAL_CONSTANT * sumX[i - begin];
+                ay[i] = Constants::GRAVITATIONAL_CONSTANT * sumY[i - begin];
+            }
+        });
+    }
+
+    void DirectSolver::computeActiveAccelerations(BodyStorage& storage, const std::vector<uint32_t>& active, ThreadPool& pool) {
+        if (precision == Precision::Mixed) {
+            computeMixed(storage, &active, pool);
+            return;
+        }
+
+        const size_t n = storage.size();
+        const double* x = storage.x.data();
+        const double* y = storage.y.data();
+        const double* mass = storage.mass.data();
+        double* ax = storage.ax.data();
+        double* ay = storage.ay.data();
+
+        const GravityKernel::Function accumulate = GravityKernel::get(kernel);
+        const double eps2 = softening * softening;
+
+        // Active bodies are scattered, so each one is a tile of its own
+        pool.parallelFor(active.size(), 16, [&](size_t begin, size_t end, size_t) {
+            for (size_t k = begin; k < end; k++) {
+                const size_t i = active[k];
+                double sumX = 0.0, sumY = 0.0;
+
+                for (size_t blockBegin = 0; blockBegin < n; blockBegin += BlockSize) {
+                    const size_t blockEnd = std::min(blockBegin + BlockSize, n);
+                    accumulate(x, y, mass, i, i + 1, blockBegin, blockEnd, eps2, &sumX, &sumY);
+                }
+
+                ax[i] = Constants::GRAVITATIONAL_CONSTANT * sumX;
+                ay[i] = Constants::GRAVITATIONAL_CONSTANT * sumY;
+            }
+        });
+    }
+
+    void DirectSolver::computeSymmetric(BodyStorage& storage, ThreadPool& pool) {
+        const size_t n = storage.size();
+        if (n == 0) return;
+
+        const double* x = storage.x.data();
+        const double* y = storage.y.data();
+        const double* mass = storage.mass.data();
+        double* ax = storage.ax.data();
+        double* ay = storage.ay.data();
+
+        const GravityKernel::SymmetricFunction accumulate = GravityKernel::getSymmetric(kernel);
+        const double eps2 = softening * softening;
+
+        // Row i holds n - 1 - i pairs, split the rows so every chunk gets about the same number of pairs.
+        // The split does not depend on the pool, the chunks are only scheduled over it.
+        const size_t chunks = std::min(SymmetricChunks, n);
+        const double pairsPerChunk = 0.5 * static_cast<double>(n) * static_cast<double>(n - 1) / chunks;
+
+        std::vector<size_t> rows(chunks + 1, n);
+        rows[0] = 0;
+        double pairs = 0.0;
+        for (size_t i = 0, chunk = 1; i < n && chunk < chunks; i++) {
+            pairs += static_cast<double>(n - 1 - i);
+            if (pairs >= pairsPerChunk * chunk) rows[chunk++] = i + 1;
+        }
+
+        buffers.assign(2 * n * chunks, 0.0);
+
+        pool.run(chunks, [&](size_t chunk, size_t) {
+            double* bufferX = buffers.data() + 2 * n * chunk;
+            double* bufferY = bufferX + n;
+            accumulate(x, y, mass, n, rows[chunk], rows[chunk + 1], eps2, bufferX, bufferY);
+        });
+
+        // Reduce the chunks in a fixed order
+        pool.parallelFor(n, BlockSize, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                double sumX = 0.0, sumY = 0.0;
+                for (size_t chunk = 0; chunk < chunks; chunk++) {
+                    sumX += buffers[2 * n * chunk + i];
+                    sumY += buffers[2 * n * chunk + n + i];
+                }
+                ax[i] = Constants::GRAVITATIONAL_CONSTANT * sumX;
+                ay[i] = Constants::GRAVITATIONAL_CONSTANT * sumY;
+            }
+        });
+    }
+
+    double DirectSolver::normalize(const BodyStorage& storage, ThreadPool& pool, float& eps2) {
+        const size_t n = storage.size();
+
+        double minX = storage.x[0], maxX = minX, minY = storage.y[0], maxY = minY, totalMass = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            minX = std::min(minX, storage.x[i]); maxX = std::max(maxX, storage.x[i]);
+            minY = std::min(minY, storage.y[i]); maxY = std::max(maxY, storage.y[i]);
+            totalMass += std::fabs(storage.mass[i]);
+        }
+
+        const double originX = 0.5 * (minX + maxX), originY = 0.5 * (minY + maxY);
+        double length = 0.5 * std::max(maxX - minX, maxY - minY);
+        if (!(length > 0.0)) length = 1.0;
+        if (!(totalMass > 0.0)) totalMass = 1.0;
+
+        const double inverseLength = 1.0 / length, inverseMass = 1.0 / totalMass;
+        unitX.resize(n);
+        unitY.resize(n);
+        unitXLow.resize(n);
+        unitYLow.resize(n);
+        unitMass.resize(n);
+        pool.parallelFor(n, BlockSize, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                const double ux = (storage.x[i] - originX) * inverseLength;
+                const double uy = (storage.y[i] - originY) * inverseLength;
+                unitX[i] = static_cast<float>(ux);
+                unitY[i] = static_cast<float>(uy);
+                unitXLow[i] = static_cast<float>(ux - unitX[i]);
+                unitYLow[i] = static_cast<float>(uy - unitY[i]);
+                unitMass[i] = static_cast<float>(storage.mass[i] * inverseMass);
+            }
+        });
+
+        eps2 = static_cast<float>(softening * softening * inverseLength * inverseLength);
+        return Constants::GRAVITATIONAL_CONSTANT * totalMass * inverseLength * inverseLength;
+    }
+
+    void DirectSolver::computeMixed(BodyStorage& storage, const std::vector<uint32_t>* active, ThreadPool& pool) {
+        const size_t n = storage.size();
+        if (n == 0) return;
+
+        float eps2;
+        const double scale = normalize(storage, pool, eps2);
+
+        const float* x = unitX.data();
+        const float* y = unitY.data();
+        const float* xLow = unitXLow.data();
+        const float* yLow = unitYLow.data();
+        const float* mass = unitMass.data();
+        double* ax = storage.ax.data();
+        double* ay = storage.ay.data();
+
+        const GravityKernel::MixedFunction accumulate = GravityKernel::getMixed(kernel);
+
+        // Sum a run of consecutive targets over every source block
+        auto evaluate = [&](size_t begin, size_t end) {
+            double sumX[TileSize] = {}, sumY[TileSize] = {};
+            double compensationX[TileSize] = {}, compensationY[TileSize] = {};
+
+            for (size_t blockBegin = 0; blockBegin < n; blockBegin += BlockSize) {
+                const size_t blockEnd = std::min(blockBegin + BlockSize, n);
+                accumulate(x, y, xLow, yLow, mass, begin, end, blockBegin, blockEnd, eps2, sumX, sumY, compensationX, compensationY);
+            }
+
+            for (size_t i = begin; i < end; i++) {
+                ax[i] = scale * (sumX[i - begin] + compensationX[i - begin]);
+                ay[i] = scale * (sumY[i - begin] + compensationY[i - begin]);
+            }
+        };
+
+        if (active == nullptr) {
+            pool.parallelFor(n, TileSize, [&](size_t begin, size_t end, size_t) { evaluate(begin, end); });
+            return;
+        }
+
+        // Active bodies are scattered, so each one is a tile of its own
+        pool.parallelFor(active->size(), 16, [&](size_t begin, size_t end, size_t) {
+            for (size_t k = begin; k < end; k++) evaluate((*active)[k], (*active)[k] + 1);
+        });
+    }
+
+} // namespace Physics
@@ -0,0 +1,433 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "../headers/FastMultipoleSolver.hpp"
+#include "../headers/BodyStorage.hpp"
+#include "../headers/ThreadPool.hpp"
+#include "../headers/Constants.hpp"
+
+namespace Physics {
+
+    using Complex = FastMultipoleSolver::Complex;
+
+    // Plain complex product. std::complex's operator* also handles inf/NaN
+    // operands through a library call, which dominates the translation loops.
+    static inline Complex multiply(Complex a, Complex b) {
+        return Complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+    }
+
+    FastMultipoleSolver::FastMultipoleSolver(int order, size_t leafSize, double softening)
+        : order(order), leafSize(std::max<size_t>(leafSize, 1)), softening(softening) {
+        if (order < 0 || order > MaxOrder) {
+            throw std::invalid_argument("FMM order must be between 0 and " + std::to_string(MaxOrder));
+        }
+        prepare();
+    }
+
+    void FastMultipoleSolver::setOrder(int order) {
+        if (order < 0 || order > MaxOrder) {
+            throw std::invalid_argument("FMM order must be between 0 and " + std::to_string(MaxOrder));
+        }
+        this->order = order;
+        prepare();
+    }
+
+    int FastMultipoleSolver::getOrder() const { return order; }
+
+    void FastMultipoleSolver::setLeafSize(size_t leafSize) { this->leafSize = std::max<size_t>(leafSize, 1); }
+    size_t FastMultipoleSolver::getLeafSize() const { return leafSize; }
+
+    void FastMultipoleSolver::setSoftening(double softening) { this->softening = softening; }
+    double FastMultipoleSolver::getSoftening() const { return softening; }
+
+    int FastMultipoleSolver::getLevels() const { return levels; }
+
+    void FastMultipoleSolver::prepare() {
+        const int n = order + 1;
+
+        // Coefficient blocks are ordered by degree p + q, then by q
+        index.assign(n * n, -1);
+        terms = 0;
+        for (int degree = 0; degree <= order; degree++) {
+            for (int q = 0; q <= degree; q++) {
+                index[(degree - q) * n + q] = terms++;
+            }
+        }
+
+        binomial.assign(n * n, 0.0);
+        for (int i = 0; i < n; i++) {
+            binomial[i * n] = 1.0;
+            for (int k = 1; k <= i; k++) {
+                binomial[i * n + k] = binomial[(i - 1) * n + k - 1] + (k < i ? binomial[(i - 1) * n + k] : 0.0);
+            }
+        }
+
+        // (1 - x)^(-1/2) = sum a_p x^p
+        std::vector<double> a(n);
+        a[0] = 1.0;
+        for (int p = 1; p < n; p++) a[p] = a[p - 1] * (2.0 * p - 1.0) / (2.0 * p);
+
+        multipoleScale.assign(terms, 0.0);
+        for (int p = 0; p <= order; p++) {
+            for (int q = 0; p + q <= order; q++) {
+                multipoleScale[idx(p, q)] = a[p] * a[q];
+            }
+        }
+
+        // (1 + x)^(-p-1/2) = sum binom(-p - 1/2, k) x^k
+        localScale.assign(n * n, 0.0);
+        for (int p = 0; p < n; p++) {
+            double c = 1.0;
+            for (int k = 0; k < n; k++) {
+                localScale[p * n + k] = c;
+                c *= (-p - 0.5 - k) / (k + 1.0);
+            }
+        }
+    }
+
+    size_t FastMultipoleSolver::levelOffset(int level) {
+        // 1 + 4 + 16 + ... boxes in the levels above
+        return ((size_t(1) << (2 * level)) - 1) / 3;
+    }
+
+    Complex FastMultipoleSolver::center(int level, uint32_t ix, uint32_t iy) const {
+        const double width = 1.0 / double(1u << level);
+        return Complex((ix + 0.5) * width, (iy + 0.5) * width);
+    }
+
+    void FastMultipoleSolver::build(const BodyStorage& storage) {
+        const size_t n = storage.size();
+        const double* x = storage.x.data();
+        const double* y = storage.y.data();
+
+        double minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+        for (size_t i = 1; i < n; i++) {
+            minX = std::min(minX, x[i]); maxX = std::max(maxX, x[i]);
+            minY = std::min(minY, y[i]); maxY = std::max(maxY, y[i]);
+        }
+
+        // Square root box, slightly enlarged so every body falls strictly inside
+        size = std::max(maxX - minX, maxY - minY) * (1.0 + 1e-9);
+        if (size <= 0.0) size = 1.0;
+        originX = 0.5 * (minX + maxX) - 0.5 * size;
+        originY = 0.5 * (minY + maxY) - 0.5 * size;
+
+        // Depth so that leaves hold about leafSize bodies
+        levels = 2;
+        while (levels < MaxLevel && (n >> (2 * levels)) > leafSize) levels++;
+
+        const uint32_t side = 1u << levels;
+        const size_t leaves = size_t(side) * side;
+
+        // Counting sort of the bodies by leaf
+        std::vector<uint32_t> leafOf(n);
+        leafStart.assign(leaves + 1, 0);
+        for (size_t i = 0; i < n; i++) {
+            uint32_t ix = std::min(side - 1, static_cast<uint32_t>((x[i] - originX) / size * side));
+            uint32_t iy = std::min(side - 1, static_cast<uint32_t>((y[i] - originY) / size * side));
+            leafOf[i] = iy * side + ix;
+            leafStart[leafOf[i] + 1]++;
+        }
+        for (size_t b = 0; b < leaves; b++) leafStart[b + 1] += leafStart[b];
+
+        sorted.resize(n);
+        std::vector<uint32_t> cursor(leafStart.begin(), leafStart.end() - 1);
+        for (size_t i = 0; i < n; i++) sorted[cursor[leafOf[i]]++] = static_cast<uint32_t>(i);
+
+        sx.resize(n); sy.resize(n); sm.resize(n);
+        for (size_t k = 0; k < n; k++) {
+            uint32_t i = sorted[k];
+            sx[k] = (x[i] - originX) / size;
+            sy[k] = (y[i] - originY) / size;
+            sm[k] = storage.mass[i];
+        }
+
+        // Body counts for every box, finest level first
+        counts.assign(levelOffset(levels + 1), 0);
+        for (size_t b = 0; b < leaves; b++) {
+            counts[levelOffset(levels) + b] = leafStart[b + 1] - leafStart[b];
+        }
+        for (int level = levels - 1; level >= 0; level--) {
+            const uint32_t width = 1u << level;
+            for (uint32_t iy = 0; iy < width; iy++) {
+                for (uint32_t ix = 0; ix < width; ix++) {
+                    uint32_t total = 0;
+                    for (uint32_t c = 0; c < 4; c++) {
+                        total += counts[levelOffset(level + 1) + (2 * iy + (c >> 1)) * 2 * width + 2 * ix + (c & 1)];
+                    }
+                    counts[levelOffset(level) + iy * width + ix] = total;
+                }
+            }
+        }
+
+        multipoles.assign(counts.size() * terms, Complex(0.0, 0.0));
+        locals.assign(counts.size() * terms, Complex(0.0, 0.0));
+    }
+
+    void FastMultipoleSolver::particleToMultipole(uint32_t leaf) {
+        const uint32_t side = 1u << levels;
+        const Complex c = center(levels, leaf % side, leaf / side);
+        Complex* multipole = multipoles.data() + (levelOffset(levels) + leaf) * terms;
+
+        std::vector<Complex> powers(order + 1), conjugatePowers(order + 1);
+
+        for (uint32_t k = leafStart[leaf]; k < leafStart[leaf + 1]; k++) {
+            const Complex u = Complex(sx[k], sy[k]) - c;
+
+            powers[0] = conjugatePowers[0] = 1.0;
+            for (int p = 1; p <= order; p++) {
+                powers[p] = multiply(powers[p - 1], u);
+                conjugatePowers[p] = std::conj(powers[p]);
+            }
+
+            // m u^p conj(u)^q
+            for (int p = 0; p <= order; p++) {
+                const Complex weighted = sm[k] * powers[p];
+                for (int q = 0; p + q <= order; q++) {
+                    multipole[idx(p, q)] += multiply(weighted, conjugatePowers[q]);
+                }
+            }
+        }
+    }
+
+    void FastMultipoleSolver::multipoleToMultipole(int level, uint32_t ix, uint32_t iy) {
+        const Complex parentCenter = center(level, ix, iy);
+        Complex* parent = multipoles.data() + (levelOffset(level) + iy * (1u << level) + ix) * terms;
+        const int n = order + 1;
+
+        std::vector<Complex> powers(n), conjugatePowers(n);
+
+        for (uint32_t c = 0; c < 4; c++) {
+            const uint32_t cx = 2 * ix + (c & 1), cy = 2 * iy + (c >> 1);
+            const size_t box = levelOffset(level + 1) + cy * (2u << level) + cx;
+            if (counts[box] == 0) continue;
+
+            const Complex* child = multipoles.data() + box * terms;
+            const Complex d = center(level + 1, cx, cy) - parentCenter;
+
+            powers[0] = conjugatePowers[0] = 1.0;
+            for (int p = 1; p <= order; p++) {
+                powers[p] = multiply(powers[p - 1], d);
+                conjugatePowers[p] = std::conj(powers[p]);
+            }
+
+            // (u + d)^p conj(u + d)^q expanded binomially
+            for (int p = 0; p <= order; p++) {
+                for (int q = 0; p + q <= order; q++) {
+                    Complex sum = 0.0;
+                    for (int k = 0; k <= p; k++) {
+                        Complex row = 0.0;
+                        for (int l = 0; l <= q; l++) {
+                            row += binomial[q * n + l] * multiply(conjugatePowers[q - l], child[idx(k, l)]);
+                        }
+                        sum += binomial[p * n + k] * multiply(powers[p - k], row);
+                    }
+                    parent[idx(p, q)] += sum;
+                }
+            }
+        }
+    }
+
+    void FastMultipoleSolver::multipoleToLocal(const Complex* multipole, Complex z, Complex* local, Complex* scratch) const {
+        // z points from the multipole center to the local center.
+        // L_kl = |z|^-1 z^-k conj(z)^-l sum_pq a_p a_q M_pq b(p, k) b(q, l) z^-p conj(z)^-q
+        const int n = order + 1;
+        Complex* inversePowers = scratch;                   // z^-p
+        Complex* inverseConjugatePowers = scratch + n;      // conj(z)^-p
+        Complex* partial = scratch + 2 * n;                 // n * n, indexed [p][l]
+
+        const Complex inverse = 1.0 / z;
+        inversePowers[0] = inverseConjugatePowers[0] = 1.0;
+        for (int p = 1; p <= order; p++) {
+            inversePowers[p] = multiply(inversePowers[p - 1], inverse);
+            inverseConjugatePowers[p] = std::conj(inversePowers[p]);
+        }
+        const double inverseDistance = 1.0 / std::abs(z);
+
+        // partial[p][l] = sum_q a_p a_q M_pq b(q, l) conj(z)^-q
+        for (int p = 0; p <= order; p++) {
+            for (int l = 0; l <= order; l++) {
+                Complex sum = 0.0;
+                for (int q = 0; p + q <= order; q++) {
+                    sum += (multipoleScale[idx(p, q)] * localScale[q * n + l]) * multiply(inverseConjugatePowers[q], multipole[idx(p, q)]);
+                }
+                partial[p * n + l] = sum;
+            }
+        }
+
+        // The potential is real, so L_lk = conj(L_kl) and only k >= l needs summing
+        for (int k = 0; k <= order; k++) {
+            for (int l = 0; l <= k && k + l <= order; l++) {
+                Complex sum = 0.0;
+                for (int p = 0; p <= order; p++) {
+                    sum += localScale[p * n + k] * multiply(inversePowers[p], partial[p * n + l]);
+                }
+                const Complex term = inverseDistance * multiply(multiply(inversePowers[k], inverseConjugatePowers[l]), sum);
+                local[idx(k, l)] += term;
+                if (l != k) local[idx(l, k)] += std::conj(term);
+            }
+        }
+    }
+
+    void FastMultipoleSolver::localToLocal(int level, uint32_t ix, uint32_t iy) {
+        const uint32_t px = ix / 2, py = iy / 2;
+        const Complex* parent = locals.data() + (levelOffset(level - 1) + py * (1u << (level - 1)) + px) * terms;
+        Complex* child = locals.data() + (levelOffset(level) + iy * (1u << level) + ix) * terms;
+        const Complex d = center(level, ix, iy) - center(level - 1, px, py);
+        const int n = order + 1;
+
+        std::vector<Complex> powers(n), conjugatePowers(n);
+        powers[0] = conjugatePowers[0] = 1.0;
+        for (int p = 1; p <= order; p++) {
+            powers[p] = multiply(powers[p - 1], d);
+            conjugatePowers[p] = std::conj(powers[p]);
+        }
+
+        // (s + d)^k conj(s + d)^l re-expanded around the child center
+        for (int k0 = 0; k0 <= order; k0++) {
+            for (int l0 = 0; k0 + l0 <= order; l0++) {
+                Complex sum = 0.0;
+                for (int k = k0; k <= order; k++) {
+                    for (int l = l0; k + l <= order; l++) {
+                        sum += (binomial[k * n + k0] * binomial[l * n + l0])
+                            * multiply(multiply(powers[k - k0], conjugatePowers[l - l0]), parent[idx(k, l)]);
+                    }
+                }
+                child[idx(k0, l0)] += sum;
+            }
+        }
+    }
+
+    void FastMultipoleSolver::evaluateLeaf(uint32_t ix, uint32_t iy, double* ax, double* ay) const {
+        const uint32_t side = 1u << levels;
+        const uint32_t leaf = iy * side + ix;
+        const Complex c = center(levels, ix, iy);
+        const Complex* local = locals.data() + (levelOffset(levels) + leaf) * terms;
+        const double eps = softening / size;
+        const double eps2 = eps * eps;
+
+        std::vector<Complex> powers(order + 1), conjugatePowers(order + 1);
+
+        for (uint32_t k = leafStart[leaf]; k < leafStart[leaf + 1]; k++) {
+            const double px = sx[k], py = sy[k];
+
+            // Far field: the gradient of the local expansion, a_x - i a_y = 2 dPhi/dz
+            const Complex s = Complex(px, py) - c;
+            powers[0] = conjugatePowers[0] = 1.0;
+            for (int p = 1; p <= order; p++) {
+                powers[p] = multiply(powers[p - 1], s);
+                conjugatePowers[p] = std::conj(powers[p]);
+            }
+
+            Complex gradient = 0.0;
+            for (int p = 1; p <= order; p++) {
+                for (int q = 0; p + q <= order; q++) {
+                    gradient += double(p) * multiply(local[idx(p, q)], multiply(powers[p - 1], conjugatePowers[q]));
+                }
+            }
+
+            double accelerationX = 2.0 * gradient.real();
+            double accelerationY = -2.0 * gradient.imag();
+
+            // Near field: direct sum over this leaf and its neighbours
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    int nx = int(ix) + dx, ny = int(iy) + dy;
+                    if (nx < 0 || ny < 0 || nx >= int(side) || ny >= int(side)) continue;
+
+                    const uint32_t neighbour = uint32_t(ny) * side + uint32_t(nx);
+                    for (uint32_t j = leafStart[neighbour]; j < leafStart[neighbour + 1]; j++) {
+                        double rx = sx[j] - px;
+                        double ry = sy[j] - py;
+                        double r2 = rx * rx + ry * ry + eps2;
+                        if (r2 <= 0.0) continue;
+
+                        double rInv = 1.0 / std::sqrt(r2);
+                        double t = sm[j] * rInv * rInv * rInv;
+                        accelerationX += t * rx;
+                        accelerationY += t * ry;
+                    }
+                }
+            }
+
+            ax[k] = accelerationX;
+            ay[k] = accelerationY;
+        }
+    }
+
+    void FastMultipoleSolver::computeAccelerations(BodyStorage& storage, ThreadPool& pool) {
+        const size_t n = storage.size();
+        if (n == 0) return;
+
+        build(storage);
+
+        const uint32_t side = 1u << levels;
+
+        // Upward pass: leaves, then parents
+        pool.parallelFor(size_t(side) * side, 64, [&](size_t begin, size_t end, size_t) {
+            for (size_t leaf = begin; leaf < end; leaf++) {
+                if (leafStart[leaf + 1] > leafStart[leaf]) particleToMultipole(static_cast<uint32_t>(leaf));
+            }
+        });
+
+        for (int level = levels - 1; level >= 2; level--) {
+            const uint32_t width = 1u << level;
+            pool.parallelFor(size_t(width) * width, 64, [&](size_t begin, size_t end, size_t) {
+                for (size_t box = begin; box < end; box++) {
+                    if (counts[levelOffset(level) + box] == 0) continue;
+                    multipoleToMultipole(level, static_cast<uint32_t>(box % width), static_cast<uint32_t>(box / width));
+                }
+            });
+        }
+
+        // Downward pass: inherit from the parent, then add the interaction list,
+        // the children of the parent's neighbours that are not adjacent to the box
+        for (int level = 2; level <= levels; level++) {
+            const uint32_t width = 1u << level;
+            pool.parallelFor(size_t(width) * width, 16, [&](size_t begin, size_t end, size_t) {
+                std::vector<Complex> scratch(2 * (order + 1) + (order + 1) * (order + 1));
+
+                for (size_t box = begin; box < end; box++) {
+                    if (counts[levelOffset(level) + box] == 0) continue;
+
+                    const int ix = static_cast<int>(box % width), iy = static_cast<int>(box / width);
+                    if (level > 2) localToLocal(level, ix, iy);
+
+                    Complex* local = locals.data() + (levelOffset(level) + box) * terms;
+                    const Complex c = center(level, ix, iy);
+
+                    for (int jy = 2 * (iy / 2 - 1); jy <= 2 * (iy / 2 + 1) + 1; jy++) {
+                        for (int jx = 2 * (ix / 2 - 1); jx <= 2 * (ix / 2 + 1) + 1; jx++) {
+                            if (jx < 0 || jy < 0 || jx >= int(width) || jy >= int(width)) continue;
+                            if (std::abs(jx - ix) <= 1 && std::abs(jy - iy) <= 1) continue;
+
+                            const size_t source = levelOffset(level) + jy * width + jx;
+                            if (counts[source] == 0) continue;
+
+                            multipoleToLocal(multipoles.data() + source * terms, c - center(level, jx, jy), local, scratch.data());
+                        }
+                    }
+                }
+            });
+        }
+
+        // Evaluate at the bodies, in sorted order
+        std::vector<double> sortedX(n), sortedY(n);
+        pool.parallelFor(size_t(side) * side, 64, [&](size_t begin, size_t end, size_t) {
+            for (size_t leaf = begin; leaf < end; leaf++) {
+                if (leafStart[leaf + 1] > leafStart[leaf]) {
+                    evaluateLeaf(static_cast<uint32_t>(leaf % side), static_cast<uint32_t>(leaf / side), sortedX.data(), sortedY.data());
+                }
+            }
+        });
+
+        // Back to body order and SI units
+        const double scale = Constants::GRAVITATIONAL_CONSTANT / (size * size);
+        for (size_t k = 0; k < n; k++) {
+            storage.ax[sorted[k]] = scale * sortedX[k];
+            storage.ay[sorted[k]] = scale * sortedY[k];
+        }
+    }
+
+} // namespace Physics
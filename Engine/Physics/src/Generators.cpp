@@ -0,0 +1,334 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "../headers/Generators.hpp"
+#include "../headers/World.hpp"
+#include "../headers/ThreadPool.hpp"
+#include "../headers/Constants.hpp"
+
+#include "../../Math/headers/Philox.hpp"
+#include "../../Math/headers/Constants.hpp"
+
+namespace Physics {
+
+    // Bodies generated per task
+    static constexpr size_t GenerationGrain = 4096;
+
+    static constexpr double G = Constants::GRAVITATIONAL_CONSTANT;
+
+    // Modified Bessel functions scaled to stay finite for any argument:
+    // i0(x) = I0(x) e^-x, i1(x) = I1(x) e^-x, k0(x) = K0(x) e^x, k1(x) = K1(x) e^x.
+    // Polynomial approximations of Abramowitz & Stegun 9.8.1 - 9.8.8, relative error below 5e-7.
+    static double scaledI0(double x) {
+        if (x < 3.75) {
+            const double t = (x / 3.75) * (x / 3.75);
+            return std::exp(-x) * (1.0 + t * (3.5156229 + t * (3.0899424 + t * (1.2067492
+                + t * (0.2659732 + t * (0.0360768 + t * 0.0045813))))));
+        }
+        const double t = 3.75 / x;
+        return (0.39894228 + t * (0.01328592 + t * (0.00225319 + t * (-0.00157565 + t * (0.00916281
+            + t * (-0.02057706 + t * (0.02635537 + t * (-0.01647633 + t * 0.00392377)))))))) / std::sqrt(x);
+    }
+
+    static double scaledI1(double x) {
+        if (x < 3.75) {
+            const double t = (x / 3.75) * (x / 3.75);
+            return std::exp(-x) * x * (0.5 + t * (0.87890594 + t * (0.51498869 + t * (0.15084934
+                + t * (0.02658733 + t * (0.00301532 + t * 0.00032411))))));
+        }
+        const double t = 3.75 / x;
+        return (0.39894228 + t * (-0.03988024 + t * (-0.00362018 + t * (0.00163801 + t * (-0.01031555
+            + t * (0.02282967 + t * (-0.02895312 + t * (0.01787654 - t * 0.00420059)))))))) / std::sqrt(x);
+    }
+
+    static double scaledK0(double x) {
+        if (x <= 2.0) {
+            const double t = (x / 2.0) * (x / 2.0);
+            const double series = -0.57721566 + t * (0.42278420 + t * (0.23069756 + t * (0.03488590
+                + t * (0.00262698 + t * (0.00010750 + t * 0.00000740)))));
+            return std::exp(x) * (-std::log(x / 2.0) * scaledI0(x) * std::exp(x) + series);
+        }
+        const double t = 2.0 / x;
+        return (1.25331414 + t * (-0.07832358 + t * (0.02189568 + t * (-0.01062446 + t * (0.00587872
+            + t * (-0.00251540 + t * 0.00053208)))))) / std::sqrt(x);
+    }
+
+    static double scaledK1(double x) {
+        if (x <= 2.0) {
+            const double t = (x / 2.0) * (x / 2.0);
+            const double series = 1.0 + t * (0.15443144 + t * (-0.67278579 + t * (-0.18156897
+                + t * (-0.01919402 + t * (-0.00110404 - t * 0.00004686)))));
+            return std::exp(x) * (std::log(x / 2.0) * scaledI1(x) * std::exp(x) + series / x);
+        }
+        const double t = 2.0 / x;
+        return (1.25331414 + t * (0.23498619 + t * (-0.03655620 + t * (0.01504268 + t * (-0.00780353
+            + t * (0.00325614 - t * 0.00068245)))))) / std::sqrt(x);
+    }
+
+    // Circular speed squared in the plane of a razor-thin exponential disk (Freeman 1970),
+    // v^2 = 4 pi G sigma0 Rd y^2 (I0 K0 - I1 K1)(y) with y = R / (2 Rd)
+    static double diskCircularSpeed2(double radius, double mass, double scaleLength) {
+        const double y = radius / (2.0 * scaleLength);
+        const double bessel = scaledI0(y) * scaledK0(y) - scaledI1(y) * scaledK1(y);
+        return 2.0 * G * mass / scaleLength * y * y * bessel;
+    }
+
+    // Random direction in the plane
+    static void direction(Math::Philox& random, double& cosine, double& sine) {
+        const double angle = Math::Constants::TAU * random.uniform();
+        cosine = std::cos(angle);
+        sine = std::sin(angle);
+    }
+
+    // Projection onto the plane of a random direction in space
+    static void projectedDirection(Math::Philox& random, double& dx, double& dy) {
+        const double z = random.uniform(-1.0, 1.0);
+        const double planar = std::sqrt(1.0 - z * z);
+        double cosine, sine;
+        direction(random, cosine, sine);
+        dx = planar * cosine;
+        dy = planar * sine;
+    }
+
+    static void setMass(BodyStorage& storage, size_t i, double mass) {
+        storage.mass[i] = mass;
+        storage.invMass[i] = 1.0 / mass;
+    }
+
+    // Remove the centre of mass position and velocity. Summed serially in index order,
+    // so the result does not depend on the thread count.
+    static void toCenterOfMassFrame(BodyStorage& storage, ThreadPool& pool) {
+        double mass = 0.0, x = 0.0, y = 0.0, vx = 0.0, vy = 0.0;
+        for (size_t i = 0; i < storage.size(); i++) {
+            mass += storage.mass[i];
+            x += storage.mass[i] * storage.x[i];
+            y += storage.mass[i] * storage.y[i];
+            vx += storage.mass[i] * storage.vx[i];
+            vy += storage.mass[i] * storage.vy[i];
+        }
+        if (!(mass > 0.0)) return;
+        x /= mass; y /= mass; vx /= mass; vy /= mass;
+
+        pool.parallelFor(storage.size(), GenerationGrain, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                storage.x[i] -= x; storage.y[i] -= y;
+                storage.vx[i] -= vx; storage.vy[i] -= vy;
+            }
+        });
+    }
+
+    BodyStorage Generators::plummer(const PlummerOptions& options, uint64_t seed, ThreadPool& pool) {
+        if (!(options.totalMass > 0.0) || !(options.scaleRadius > 0.0) || !(options.maxRadius > 0.0)) {
+            throw std::invalid_argument("Plummer mass and radii must be positive");
+        }
+
+        BodyStorage storage;
+        storage.resize(options.count);
+
+        // Sampled in units G = M = a = 1, then scaled
+        const double velocityScale = std::sqrt(G * options.totalMass / options.scaleRadius);
+        const double bodyMass = options.totalMass / double(options.count);
+
+        pool.parallelFor(options.count, GenerationGrain, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                Math::Philox random(seed, i);
+
+                // Radius from the inverse of the cumulative mass M(r) = r^3 / (1 + r^2)^(3/2)
+                double r;
+                do {
+                    const double m = 1.0 - random.uniform();
+                    r = 1.0 / std::sqrt(std::pow(m, -2.0 / 3.0) - 1.0);
+                } while (!(r <= options.maxRadius));
+
+                // Speed as a fraction q of the escape speed, g(q) = q^2 (1 - q^2)^(7/2) by rejection
+                double q;
+                do {
+                    q = random.uniform();
+                } while (0.1 * random.uniform() >= q * q * std::pow(1.0 - q * q, 3.5));
+                const double speed = q * std::sqrt(2.0) * std::pow(1.0 + r * r, -0.25);
+
+                double dx, dy;
+                projectedDirection(random, dx, dy);
+                storage.x[i] = r * dx * options.scaleRadius;
+                storage.y[i] = r * dy * options.scaleRadius;
+
+                projectedDirection(random, dx, dy);
+                storage.vx[i] = speed * dx * velocityScale;
+                storage.vy[i] = speed * dy * velocityScale;
+
+                setMass(storage, i, bodyMass);
+            }
+        });
+
+        if (options.centerOfMassFrame) toCenterOfMassFrame(storage, pool);
+        return storage;
+    }
+
+    BodyStorage Generators::disk(const DiskOptions& options, uint64_t seed, ThreadPool& pool) {
+        if (!(options.diskMass > 0.0) || !(options.scaleLength > 0.0) || !(options.maxRadius > 0.0)) {
+            throw std::invalid_argument("Disk mass and radii must be positive");
+        }
+        if (options.centralMass < 0.0 || options.dispersion < 0.0 || options.radius < 0.0 || options.centralRadius < 0.0) {
+            throw std::invalid_argument("Disk central mass, radii and dispersion cannot be negative");
+        }
+
+        const size_t first = options.centralMass > 0.0 ? 1 : 0;
+        BodyStorage storage;
+        storage.resize(first + options.count);
+        if (first) {
+            setMass(storage, 0, options.centralMass);
+            storage.radius[0] = options.centralRadius;
+        }
+
+        const double bodyMass = options.diskMass / double(options.count);
+
+        pool.parallelFor(options.count, GenerationGrain, [&](size_t begin, size_t end, size_t) {
+            for (size_t j = begin; j < end; j++) {
+                Math::Philox random(seed, j);
+                const size_t i = first + j;
+
+                // R / Rd follows the Gamma(2) distribution, the sum of two exponential deviates
+                double radius;
+                do {
+                    radius = random.exponential() + random.exponential();
+                } while (!(radius <= options.maxRadius) || radius == 0.0);
+                radius *= options.scaleLength;
+
+                double cosine, sine;
+                direction(random, cosine, sine);
+                storage.x[i] = radius * cosine;
+                storage.y[i] = radius * sine;
+
+                // Counter-clockwise circular orbit with a random kick
+                const double speed = std::sqrt(diskCircularSpeed2(radius, options.diskMass, options.scaleLength)
+                    + G * options.centralMass / radius);
+                const double sigma = options.dispersion * speed;
+                storage.vx[i] = -speed * sine + sigma * random.normal();
+                storage.vy[i] = speed * cosine + sigma * random.normal();
+
+                setMass(storage, i, bodyMass);
+                storage.radius[i] = options.radius;
+            }
+        });
+
+        if (options.centerOfMassFrame) toCenterOfMassFrame(storage, pool);
+        return storage;
+    }
+
+    BodyStorage Generators::ring(const RingOptions& options, uint64_t seed, ThreadPool& pool) {
+        if (!(options.centralMass > 0.0) || !(options.particleMass > 0.0)) {
+            throw std::invalid_argument("Ring masses must be positive");
+        }
+        if (!(options.innerRadius > 0.0) || !(options.outerRadius > options.innerRadius)) {
+            throw std::invalid_argument("Ring radii must satisfy 0 < innerRadius < outerRadius");
+        }
+        if (options.radius < 0.0 || options.centralRadius < 0.0) {
+            throw std::invalid_argument("Ring radii cannot be negative");
+        }
+        // Eccentricities at or above 0.9 are redrawn, which never ends for a large scale
+        if (!(options.eccentricity >= 0.0) || !(options.eccentricity < 0.9)) {
+            throw std::invalid_argument("Ring eccentricity scale must satisfy 0 <= eccentricity < 0.9");
+        }
+
+        BodyStorage storage;
+        storage.resize(1 + options.count);
+        setMass(storage, 0, options.centralMass);
+        storage.radius[0] = options.centralRadius;
+
+        const double mu = G * (options.centralMass + options.particleMass);
+        const double inner2 = options.innerRadius * options.innerRadius;
+        const double outer2 = options.outerRadius * options.outerRadius;
+
+        pool.parallelFor(options.count, GenerationGrain, [&](size_t begin, size_t end, size_t) {
+            for (size_t j = begin; j < end; j++) {
+                Math::Philox random(seed, j);
+                const size_t i = 1 + j;
+
+                // Orbital elements, bound orbits only
+                const double a = std::sqrt(inner2 + random.uniform() * (outer2 - inner2));
+                double e;
+                do {
+                    e = options.eccentricity * std::sqrt(2.0 * random.exponential());
+                } while (e >= 0.9);
+                double cosOmega, sinOmega;
+                direction(random, cosOmega, sinOmega);
+                const double meanAnomaly = Math::Constants::TAU * random.uniform();
+
+                // Kepler's equation M = E - e sin E by Newton's method
+                double E = meanAnomaly;
+                for (int iteration = 0; iteration < 16; iteration++) {
+                    const double delta = (E - e * std::sin(E) - meanAnomaly) / (1.0 - e * std::cos(E));
+                    E -= delta;
+                    if (std::abs(delta) < 1.0e-15) break;
+                }
+
+                // Perifocal position and velocity, then rotate by the argument of periapsis
+                const double cosE = std::cos(E), sinE = std::sin(E);
+                const double semiMinor = std::sqrt(1.0 - e * e);
+                const double r = a * (1.0 - e * cosE);
+                const double px = a * (cosE - e), py = a * semiMinor * sinE;
+                const double speed = std::sqrt(mu * a) / r;
+                const double pvx = -speed * sinE, pvy = speed * semiMinor * cosE;
+
+                storage.x[i] = px * cosOmega - py * sinOmega;
+                storage.y[i] = px * sinOmega + py * cosOmega;
+                storage.vx[i] = pvx * cosOmega - pvy * sinOmega;
+                storage.vy[i] = pvx * sinOmega + pvy * cosOmega;
+
+                setMass(storage, i, options.particleMass);
+                storage.radius[i] = options.radius;
+            }
+        });
+
+        if (options.centerOfMassFrame) toCenterOfMassFrame(storage, pool);
+        return storage;
+    }
+
+    BodyStorage Generators::box(const BoxOptions& options, uint64_t seed, ThreadPool& pool) {
+        if (!(options.halfSize > 0.0) || !(options.minMass > 0.0) || !(options.maxMass >= options.minMass)) {
+            throw std::invalid_argument("Box size and masses must be positive with minMass <= maxMass");
+        }
+        if (options.velocityDispersion < 0.0 || options.radius < 0.0) {
+            throw std::invalid_argument("Box velocity dispersion and radius cannot be negative");
+        }
+
+        BodyStorage storage;
+        storage.resize(options.count);
+
+        pool.parallelFor(options.count, GenerationGrain, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                Math::Philox random(seed, i);
+                storage.x[i] = random.uniform(-options.halfSize, options.halfSize);
+                storage.y[i] = random.uniform(-options.halfSize, options.halfSize);
+                storage.vx[i] = options.velocityDispersion * random.normal();
+                storage.vy[i] = options.velocityDispersion * random.normal();
+                setMass(storage, i, random.uniform(options.minMass, options.maxMass));
+                storage.radius[i] = options.radius;
+            }
+        });
+
+        if (options.centerOfMassFrame) toCenterOfMassFrame(storage, pool);
+        return storage;
+    }
+
+    size_t Generators::plummer(World& world, const PlummerOptions& options, uint64_t seed) {
+        const size_t first = world.addBodies(plummer(options, seed, world.getThreadPool()));
+        return world.numBodies() - first;
+    }
+
+    size_t Generators::disk(World& world, const DiskOptions& options, uint64_t seed) {
+        const size_t first = world.addBodies(disk(options, seed, world.getThreadPool()));
+        return world.numBodies() - first;
+    }
+
+    size_t Generators::ring(World& world, const RingOptions& options, uint64_t seed) {
+        const size_t first = world.addBodies(ring(options, seed, world.getThreadPool()));
+        return world.numBodies() - first;
+    }
+
+    size_t Generators::box(World& world, const BoxOptions& options, uint64_t seed) {
+        const size_t first = world.addBodies(box(options, seed, world.getThreadPool()));
+        return world.numBodies() - first;
+    }
+
+} // namespace Physics
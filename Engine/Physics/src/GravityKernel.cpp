@@ -0,0 +1,599 @@
+#include <cmath>
+#include <cstdint>
+
+#include "../headers/GravityKernel.hpp"
+
+// The vector kernels are compiled with per-function target attributes and
+// picked at runtime, so the rest of the engine needs no special flags.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PHYSICS_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+namespace Physics {
+
+    // Iterations of a mixed kernel's inner loop summed in float before the lanes are flushed to double
+    static constexpr size_t MixedRun = 16;
+
+    // sum + compensation += value, keeping the rounding error of the addition (Neumaier)
+    static inline void addCompensated(double& sum, double& compensation, double value) {
+        const double total = sum + value;
+        compensation += std::fabs(sum) >= std::fabs(value) ? (sum - total) + value : (value - total) + sum;
+        sum = total;
+    }
+
+    GravityKernel::Isa GravityKernel::detect() {
+        if (supported(Isa::AVX512)) return Isa::AVX512;
+        if (supported(Isa::AVX2)) return Isa::AVX2;
+        return Isa::Scalar;
+    }
+
+    bool GravityKernel::supported(Isa isa) {
+        switch (isa) {
+        case Isa::Scalar:
+            return true;
+#ifdef PHYSICS_KERNEL_X86
+        case Isa::AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case Isa::AVX512:
+            return __builtin_cpu_supports("avx512f");
+#endif
+        default:
+            return false;
+        }
+    }
+
+    GravityKernel::Function GravityKernel::get(Isa isa) {
+        if (!supported(isa)) return &GravityKernel::scalar;
+
+        switch (isa) {
+        case Isa::AVX2: return &GravityKernel::avx2;
+        case Isa::AVX512: return &GravityKernel::avx512;
+        default: return &GravityKernel::scalar;
+        }
+    }
+
+    GravityKernel::SymmetricFunction GravityKernel::getSymmetric(Isa isa) {
+        if (!supported(isa)) return &GravityKernel::scalarSymmetric;
+
+        switch (isa) {
+        case Isa::AVX2: return &GravityKernel::avx2Symmetric;
+        case Isa::AVX512: return &GravityKernel::avx512Symmetric;
+        default: return &GravityKernel::scalarSymmetric;
+        }
+    }
+
+    GravityKernel::MixedFunction GravityKernel::getMixed(Isa isa) {
+        if (!supported(isa)) return &GravityKernel::scalarMixed;
+
+        switch (isa) {
+        case Isa::AVX2: return &GravityKernel::avx2Mixed;
+        case Isa::AVX512: return &GravityKernel::avx512Mixed;
+        default: return &GravityKernel::scalarMixed;
+        }
+    }
+
+    const char* GravityKernel::name(Isa isa) {
+        switch (isa) {
+        case Isa::AVX2: return "AVX2";
+        case Isa::AVX512: return "AVX-512";
+        default: return "Scalar";
+        }
+    }
+
+    void GravityKernel::scalar(const double* x, const double* y, const double* mass,
+        size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, double eps2,
+        double* sumX, double* sumY)
+    {
+        for (size_t i = iBegin; i < iEnd; i++) {
+            const double px = x[i], py = y[i];
+            double accelerationX = 0.0, accelerationY = 0.0;
+
+            for (size_t j = jBegin; j < jEnd; j++) {
+                double dx = x[j] - px;
+                double dy = y[j] - py;
+                double r2 = dx * dx + dy * dy + eps2;
+                if (r2 <= 0.0) continue;
+
+                double rInv = 1.0 / std::sqrt(r2);
+                double s = mass[j] * rInv * rInv * rInv;
+                accelerationX += s * dx;
+                accelerationY += s * dy;
+            }
+
+            sumX[i - iBegin] += accelerationX;
+            sumY[i - iBegin] += accelerationY;
+        }
+    }
+
+    void GravityKernel::scalarSymmetric(const double* x, const double* y, const double* mass, size_t n,
+        size_t iBegin, size_t iEnd, double eps2, double* accX, double* accY)
+    {
+        for (size_t i = iBegin; i < iEnd; i++) {
+            const double px = x[i], py = y[i], mi = mass[i];
+            double accelerationX = 0.0, accelerationY = 0.0;
+
+            for (size_t j = i + 1; j < n; j++) {
+                double dx = x[j] - px;
+                double dy = y[j] - py;
+                double r2 = dx * dx + dy * dy + eps2;
+                if (r2 <= 0.0) continue;
+
+                double rInv = 1.0 / std::sqrt(r2);
+                double rInv3 = rInv * rInv * rInv;
+
+                // Equal and opposite: i is pulled towards j, j towards i
+                accelerationX += mass[j] * rInv3 * dx;
+                accelerationY += mass[j] * rInv3 * dy;
+                accX[j] -= mi * rInv3 * dx;
+                accY[j] -= mi * rInv3 * dy;
+            }
+
+            accX[i] += accelerationX;
+            accY[i] += accelerationY;
+        }
+    }
+
+    void GravityKernel::scalarMixed(const float* x, const float* y, const float* xLow, const float* yLow, const float* mass,
+        size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, float eps2,
+        double* sumX, double* sumY, double* compensationX, double* compensationY)
+    {
+        for (size_t i = iBegin; i < iEnd; i++) {
+            const float px = x[i], py = y[i], pxLow = xLow[i], pyLow = yLow[i];
+            double totalX = 0.0, totalY = 0.0, errorX = 0.0, errorY = 0.0;
+
+            for (size_t run = jBegin; run < jEnd; run += MixedRun) {
+                const size_t runEnd = run + MixedRun < jEnd ? run + MixedRun : jEnd;
+                float accelerationX = 0.0f, accelerationY = 0.0f;
+
+                for (size_t j = run; j < runEnd; j++) {
+                    float dx = (x[j] - px) + (xLow[j] - pxLow);
+                    float dy = (y[j] - py) + (yLow[j] - pyLow);
+                    float r2 = dx * dx + dy * dy + eps2;
+                    if (r2 <= 0.0f) continue;
+
+                    float rInv = 1.0f / std::sqrt(r2);
+                    float s = mass[j] * rInv * rInv * rInv;
+                    accelerationX += s * dx;
+                    accelerationY += s * dy;
+                }
+
+                addCompensated(totalX, errorX, accelerationX);
+                addCompensated(totalY, errorY, accelerationY);
+            }
+
+            addCompensated(sumX[i - iBegin], compensationX[i - iBegin], totalX + errorX);
+            addCompensated(sumY[i - iBegin], compensationY[i - iBegin], totalY + errorY);
+        }
+    }
+
+#ifdef PHYSICS_KERNEL_X86
+
+    // 1 / sqrt(r2) for 4 doubles. AVX2 has no double precision rsqrt, so the
+    // initial guess comes from the exponent bits and 4 Newton steps take it
+    // from ~5 to full double precision. Lanes with r2 == 0 return 0.
+    __attribute__((target("avx2,fma")))
+    static inline __m256d rsqrtAvx2(__m256d r2) {
+        const __m256i magic = _mm256_set1_epi64x(0x5FE6EB50C7B537A9LL);
+        const __m256d threeHalves = _mm256_set1_pd(1.5);
+
+        __m256d y = _mm256_castsi256_pd(_mm256_sub_epi64(magic, _mm256_srli_epi64(_mm256_castpd_si256(r2), 1)));
+        __m256d h = _mm256_mul_pd(_mm256_set1_pd(0.5), r2);
+
+        // y = y * (1.5 - 0.5 * r2 * y * y)
+        for (int k = 0; k < 4; k++) {
+            y = _mm256_mul_pd(y, _mm256_fnmadd_pd(_mm256_mul_pd(h, y), y, threeHalves));
+        }
+
+        __m256d nonZero = _mm256_cmp_pd(r2, _mm256_setzero_pd(), _CMP_GT_OQ);
+        return _mm256_and_pd(y, nonZero);
+    }
+
+    __attribute__((target("avx2,fma")))
+    static inline double horizontalSum(__m256d v) {
+        __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+    }
+
+    // Add the pull of 4 sources to the lane accumulators
+    __attribute__((target("avx2,fma")))
+    static inline void accumulateAvx2(__m256d xj, __m256d yj, __m256d mj, __m256d px, __m256d py, __m256d eps,
+        __m256d& accelerationX, __m256d& accelerationY)
+    {
+        __m256d dx = _mm256_sub_pd(xj, px);
+        __m256d dy = _mm256_sub_pd(yj, py);
+        __m256d r2 = _mm256_fmadd_pd(dx, dx, _mm256_fmadd_pd(dy, dy, eps));
+
+        __m256d rInv = rsqrtAvx2(r2);
+        __m256d s = _mm256_mul_pd(mj, _mm256_mul_pd(rInv, _mm256_mul_pd(rInv, rInv)));
+
+        accelerationX = _mm256_fmadd_pd(s, dx, accelerationX);
+        accelerationY = _mm256_fmadd_pd(s, dy, accelerationY);
+    }
+
+    __attribute__((target("avx2,fma")))
+    void GravityKernel::avx2(const double* x, const double* y, const double* mass,
+        size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, double eps2,
+        double* sumX, double* sumY)
+    {
+        const __m256d eps = _mm256_set1_pd(eps2);
+        const size_t tail = (jEnd - jBegin) % 4;
+        const size_t jVectorEnd = jEnd - tail;
+
+        // Lanes past jEnd load a mass of 0 and contribute nothing
+        const __m256i tailMask = _mm256_setr_epi64x(
+            tail > 0 ? -1 : 0, tail > 1 ? -1 : 0, tail > 2 ? -1 : 0, 0);
+
+        for (size_t i = iBegin; i < iEnd; i++) {
+            const __m256d px = _mm256_set1_pd(x[i]);
+            const __m256d py = _mm256_set1_pd(y[i]);
+            __m256d accelerationX = _mm256_setzero_pd();
+            __m256d accelerationY = _mm256_setzero_pd();
+
+            for (size_t j = jBegin; j < jVectorEnd; j += 4) {
+                accumulateAvx2(_mm256_loadu_pd(x + j), _mm256_loadu_pd(y + j), _mm256_loadu_pd(mass + j),
+                    px, py, eps, accelerationX, accelerationY);
+            }
+
+            if (tail > 0) {
+                accumulateAvx2(
+                    _mm256_maskload_pd(x + jVectorEnd, tailMask),
+                    _mm256_maskload_pd(y + jVectorEnd, tailMask),
+                    _mm256_maskload_pd(mass + jVectorEnd, tailMask),
+                    px, py, eps, accelerationX, accelerationY);
+            }
+
+            sumX[i - iBegin] += horizontalSum(accelerationX);
+            sumY[i - iBegin] += horizontalSum(accelerationY);
+        }
+    }
+
+    // Pairs between i and 4 sources starting at j, lanes outside mask are left untouched
+    __attribute__((target("avx2,fma")))
+    static inline void accumulateSymmetricAvx2(const double* x, const double* y, const double* mass, size_t j, __m256i mask,
+        __m256d px, __m256d py, __m256d mi, __m256d eps, double* accX, double* accY,
+        __m256d& accelerationX, __m256d& accelerationY)
+    {
+        __m256d dx = _mm256_sub_pd(_mm256_maskload_pd(x + j, mask), px);
+        __m256d dy = _mm256_sub_pd(_mm256_maskload_pd(y + j, mask), py);
+        __m256d mj = _mm256_maskload_pd(mass + j, mask);
+        __m256d r2 = _mm256_fmadd_pd(dx, dx, _mm256_fmadd_pd(dy, dy, eps));
+
+        __m256d rInv = rsqrtAvx2(r2);
+        __m256d rInv3 = _mm256_mul_pd(rInv, _mm256_mul_pd(rInv, rInv));
+
+        // i is pulled towards j
+        __m256d s = _mm256_mul_pd(mj, rInv3);
+        accelerationX = _mm256_fmadd_pd(s, dx, accelerationX);
+        accelerationY = _mm256_fmadd_pd(s, dy, accelerationY);
+
+        // j is pulled towards i
+        __m256d t = _mm256_mul_pd(mi, rInv3);
+        _mm256_maskstore_pd(accX + j, mask, _mm256_fnmadd_pd(t, dx, _mm256_maskload_pd(accX + j, mask)));
+        _mm256_maskstore_pd(accY + j, mask, _mm256_fnmadd_pd(t, dy, _mm256_maskload_pd(accY + j, mask)));
+    }
+
+    __attribute__((target("avx2,fma")))
+    void GravityKernel::avx2Symmetric(const double* x, const double* y, const double* mass, size_t n,
+        size_t iBegin, size_t iEnd, double eps2, double* accX, double* accY)
+    {
+        const __m256d eps = _mm256_set1_pd(eps2);
+        const __m256i all = _mm256_set1_epi64x(-1);
+
+        for (size_t i = iBegin; i < iEnd; i++) {
+            const __m256d px = _mm256_set1_pd(x[i]);
+            const __m256d py = _mm256_set1_pd(y[i]);
+            const __m256d mi = _mm256_set1_pd(mass[i]);
+            __m256d accelerationX = _mm256_setzero_pd();
+            __m256d accelerationY = _mm256_setzero_pd();
+
+            size_t j = i + 1;
+            for (; j + 4 <= n; j += 4) {
+                accumulateSymmetricAvx2(x, y, mass, j, all, px, py, mi, eps, accX, accY, accelerationX, accelerationY);
+            }
+
+            const size_t tail = n - j;
+            if (tail > 0) {
+                const __m256i mask = _mm256_setr_epi64x(-1, tail > 1 ? -1 : 0, tail > 2 ? -1 : 0, 0);
+                accumulateSymmetricAvx2(x, y, mass, j, mask, px, py, mi, eps, accX, accY, accelerationX, accelerationY);
+            }
+
+            accX[i] += horizontalSum(accelerationX);
+            accY[i] += horizontalSum(accelerationY);
+        }
+    }
+
+    // 1 / sqrt(r2) for 8 floats: 12-bit hardware estimate and one Newton step.
+    // Lanes with r2 == 0 return 0.
+    __attribute__((target("avx2,fma")))
+    static inline __m256 rsqrtMixedAvx2(__m256 r2) {
+        __m256 y = _mm256_rsqrt_ps(r2);
+        __m256 h = _mm256_mul_ps(_mm256_set1_ps(0.5f), r2);
+        y = _mm256_mul_ps(y, _mm256_fnmadd_ps(_mm256_mul_ps(h, y), y, _mm256_set1_ps(1.5f)));
+
+        __m256 nonZero = _mm256_cmp_ps(r2, _mm256_setzero_ps(), _CMP_GT_OQ);
+        return _mm256_and_ps(y, nonZero);
+    }
+
+    // sum - compensation += value per lane (Kahan)
+    __attribute__((target("avx2,fma")))
+    static inline void addKahanAvx2(__m256d& sum, __m256d& compensation, __m256d value) {
+        __m256d corrected = _mm256_sub_pd(value, compensation);
+        __m256d total = _mm256_add_pd(sum, corrected);
+        compensation = _mm256_sub_pd(_mm256_sub_pd(total, sum), corrected);
+        sum = total;
+    }
+
+    // Widen 8 float lane sums to double and add them to two Kahan sums
+    __attribute__((target("avx2,fma")))
+    static inline void flushAvx2(__m256 lanes, __m256d* sum, __m256d* compensation) {
+        addKahanAvx2(sum[0], compensation[0], _mm256_cvtps_pd(_mm256_castps256_ps128(lanes)));
+        addKahanAvx2(sum[1], compensation[1], _mm256_cvtps_pd(_mm256_extractf128_ps(lanes, 1)));
+    }
+
+    __attribute__((target("avx2,fma")))
+    void GravityKernel::avx2Mixed(const float* x, const float* y, const float* xLow, const float* yLow, const float* mass,
+        size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, float eps2,
+        double* sumX, double* sumY, double* compensationX, double* compensationY)
+    {
+        const __m256 eps = _mm256_set1_ps(eps2);
+        const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+        for (size_t i = iBegin; i < iEnd; i++) {
+            const __m256 px = _mm256_set1_ps(x[i]);
+            const __m256 py = _mm256_set1_ps(y[i]);
+            const __m256 pxLow = _mm256_set1_ps(xLow[i]);
+            const __m256 pyLow = _mm256_set1_ps(yLow[i]);
+            __m256d totalX[2] = { _mm256_setzero_pd(), _mm256_setzero_pd() }, errorX[2] = { totalX[0], totalX[0] };
+            __m256d totalY[2] = { totalX[0], totalX[0] }, errorY[2] = { totalX[0], totalX[0] };
+
+            for (size_t run = jBegin; run < jEnd; run += 8 * MixedRun) {
+                const size_t runEnd = run + 8 * MixedRun < jEnd ? run + 8 * MixedRun : jEnd;
+                __m256 accelerationX = _mm256_setzero_ps();
+                __m256 accelerationY = _mm256_setzero_ps();
+
+                for (size_t j = run; j < runEnd; j += 8) {
+                    // Lanes past runEnd load a mass of 0 and contribute nothing
+                    const __m256i mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(runEnd - j)), lane);
+                    __m256 dx = _mm256_add_ps(_mm256_sub_ps(_mm256_maskload_ps(x + j, mask), px), _mm256_sub_ps(_mm256_maskload_ps(xLow + j, mask), pxLow));
+                    __m256 dy = _mm256_add_ps(_mm256_sub_ps(_mm256_maskload_ps(y + j, mask), py), _mm256_sub_ps(_mm256_maskload_ps(yLow + j, mask), pyLow));
+                    __m256 mj = _mm256_maskload_ps(mass + j, mask);
+                    __m256 r2 = _mm256_fmadd_ps(dx, dx, _mm256_fmadd_ps(dy, dy, eps));
+
+                    __m256 rInv = rsqrtMixedAvx2(r2);
+                    __m256 s = _mm256_mul_ps(mj, _mm256_mul_ps(rInv, _mm256_mul_ps(rInv, rInv)));
+
+                    accelerationX = _mm256_fmadd_ps(s, dx, accelerationX);
+                    accelerationY = _mm256_fmadd_ps(s, dy, accelerationY);
+                }
+
+                flushAvx2(accelerationX, totalX, errorX);
+                flushAvx2(accelerationY, totalY, errorY);
+            }
+
+            const double accelerationX = horizontalSum(_mm256_add_pd(totalX[0], totalX[1])) - horizontalSum(_mm256_add_pd(errorX[0], errorX[1]));
+            const double accelerationY = horizontalSum(_mm256_add_pd(totalY[0], totalY[1])) - horizontalSum(_mm256_add_pd(errorY[0], errorY[1]));
+            addCompensated(sumX[i - iBegin], compensationX[i - iBegin], accelerationX);
+            addCompensated(sumY[i - iBegin], compensationY[i - iBegin], accelerationY);
+        }
+    }
+
+    // 1 / sqrt(r2) for 8 doubles: 14-bit hardware estimate and 2 Newton steps.
+    // Lanes with r2 == 0 return 0.
+    __attribute__((target("avx512f")))
+    static inline __m512d rsqrtAvx512(__m512d r2) {
+        const __m512d threeHalves = _mm512_set1_pd(1.5);
+
+        __m512d y = _mm512_rsqrt14_pd(r2);
+        __m512d h = _mm512_mul_pd(_mm512_set1_pd(0.5), r2);
+
+        y = _mm512_mul_pd(y, _mm512_fnmadd_pd(_mm512_mul_pd(h, y), y, threeHalves));
+        y = _mm512_mul_pd(y, _mm512_fnmadd_pd(_mm512_mul_pd(h, y), y, threeHalves));
+
+        __mmask8 nonZero = _mm512_cmp_pd_mask(r2, _mm512_setzero_pd(), _CMP_GT_OQ);
+        return _mm512_maskz_mov_pd(nonZero, y);
+    }
+
+    __attribute__((target("avx512f")))
+    void GravityKernel::avx512(const double* x, const double* y, const double* mass,
+        size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, double eps2,
+        double* sumX, double* sumY)
+    {
+        const __m512d eps = _mm512_set1_pd(eps2);
+
+        for (size_t i = iBegin; i < iEnd; i++) {
+            const __m512d px = _mm512_set1_pd(x[i]);
+            const __m512d py = _mm512_set1_pd(y[i]);
+            __m512d accelerationX = _mm512_setzero_pd();
+            __m512d accelerationY = _mm512_setzero_pd();
+
+            for (size_t j = jBegin; j < jEnd; j += 8) {
+                // Lanes past jEnd load a mass of 0 and contribute nothing
+                const size_t count = jEnd - j;
+                const __mmask8 lanes = count >= 8 ? 0xFF : static_cast<__mmask8>((1u << count) - 1);
+
+                __m512d xj = _mm512_maskz_loadu_pd(lanes, x + j);
+                __m512d yj = _mm512_maskz_loadu_pd(lanes, y + j);
+                __m512d mj = _mm512_maskz_loadu_pd(lanes, mass + j);
+
+                __m512d dx = _mm512_sub_pd(xj, px);
+                __m512d dy = _mm512_sub_pd(yj, py);
+                __m512d r2 = _mm512_fmadd_pd(dx, dx, _mm512_fmadd_pd(dy, dy, eps));
+
+                __m512d rInv = rsqrtAvx512(r2);
+                __m512d s = _mm512_mul_pd(mj, _mm512_mul_pd(rInv, _mm512_mul_pd(rInv, rInv)));
+
+                accelerationX = _mm512_fmadd_pd(s, dx, accelerationX);
+                accelerationY = _mm512_fmadd_pd(s, dy, accelerationY);
+            }
+
+            sumX[i - iBegin] += _mm512_reduce_add_pd(accelerationX);
+            sumY[i - iBegin] += _mm512_reduce_add_pd(accelerationY);
+        }
+    }
+
+    __attribute__((target("avx512f")))
+    void GravityKernel::avx512Symmetric(const double* x, const double* y, const double* mass, size_t n,
+        size_t iBegin, size_t iEnd, double eps2, double* accX, double* accY)
+    {
+        const __m512d eps = _mm512_set1_pd(eps2);
+
+        for (size_t i = iBegin; i < iEnd; i++) {
+            const __m512d px = _mm512_set1_pd(x[i]);
+            const __m512d py = _mm512_set1_pd(y[i]);
+            const __m512d mi = _mm512_set1_pd(mass[i]);
+            __m512d accelerationX = _mm512_setzero_pd();
+            __m512d accelerationY = _mm512_setzero_pd();
+
+            for (size_t j = i + 1; j < n; j += 8) {
+                // Lanes past n are neither read nor written
+                const size_t count = n - j;
+                const __mmask8 lanes = count >= 8 ? 0xFF : static_cast<__mmask8>((1u << count) - 1);
+
+                __m512d dx = _mm512_sub_pd(_mm512_maskz_loadu_pd(lanes, x + j), px);
+                __m512d dy = _mm512_sub_pd(_mm512_maskz_loadu_pd(lanes, y + j), py);
+                __m512d mj = _mm512_maskz_loadu_pd(lanes, mass + j);
+                __m512d r2 = _mm512_fmadd_pd(dx, dx, _mm512_fmadd_pd(dy, dy, eps));
+
+                __m512d rInv = rsqrtAvx512(r2);
+                __m512d rInv3 = _mm512_mul_pd(rInv, _mm512_mul_pd(rInv, rInv));
+
+                // i is pulled towards j
+                __m512d s = _mm512_mul_pd(mj, rInv3);
+                accelerationX = _mm512_fmadd_pd(s, dx, accelerationX);
+                accelerationY = _mm512_fmadd_pd(s, dy, accelerationY);
+
+                // j is pulled towards i
+                __m512d t = _mm512_mul_pd(mi, rInv3);
+                _mm512_mask_storeu_pd(accX + j, lanes, _mm512_fnmadd_pd(t, dx, _mm512_maskz_loadu_pd(lanes, accX + j)));
+                _mm512_mask_storeu_pd(accY + j, lanes, _mm512_fnmadd_pd(t, dy, _mm512_maskz_loadu_pd(lanes, accY + j)));
+            }
+
+            accX[i] += _mm512_reduce_add_pd(accelerationX);
+            accY[i] += _mm512_reduce_add_pd(accelerationY);
+        }
+    }
+
+    // 1 / sqrt(r2) for 16 floats: 14-bit hardware estimate and one Newton step.
+    // Lanes with r2 == 0 return 0.
+    __attribute__((target("avx512f")))
+    static inline __m512 rsqrtMixedAvx512(__m512 r2) {
+        __m512 y = _mm512_rsqrt14_ps(r2);
+        __m512 h = _mm512_mul_ps(_mm512_set1_ps(0.5f), r2);
+        y = _mm512_mul_ps(y, _mm512_fnmadd_ps(_mm512_mul_ps(h, y), y, _mm512_set1_ps(1.5f)));
+
+        __mmask16 nonZero = _mm512_cmp_ps_mask(r2, _mm512_setzero_ps(), _CMP_GT_OQ);
+        return _mm512_maskz_mov_ps(nonZero, y);
+    }
+
+    // sum - compensation += value per lane (Kahan)
+    __attribute__((target("avx512f")))
+    static inline void addKahanAvx512(__m512d& sum, __m512d& compensation, __m512d value) {
+        __m512d corrected = _mm512_sub_pd(value, compensation);
+        __m512d total = _mm512_add_pd(sum, corrected);
+        compensation = _mm512_sub_pd(_mm512_sub_pd(total, sum), corrected);
+        sum = total;
+    }
+
+    // Widen 16 float lane sums to double and add them to two Kahan sums
+    __attribute__((target("avx512f")))
+    static inline void flushAvx512(__m512 lanes, __m512d* sum, __m512d* compensation) {
+        const __m256 high = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(lanes), 1));
+        addKahanAvx512(sum[0], compensation[0], _mm512_cvtps_pd(_mm512_castps512_ps256(lanes)));
+        addKahanAvx512(sum[1], compensation[1], _mm512_cvtps_pd(high));
+    }
+
+    __attribute__((target("avx512f")))
+    void GravityKernel::avx512Mixed(const float* x, const float* y, const float* xLow, const float* yLow, const float* mass,
+        size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, float eps2,
+        double* sumX, double* sumY, double* compensationX, double* compensationY)
+    {
+        const __m512 eps = _mm512_set1_ps(eps2);
+
+        for (size_t i = iBegin; i < iEnd; i++) {
+            const __m512 px = _mm512_set1_ps(x[i]);
+            const __m512 py = _mm512_set1_ps(y[i]);
+            const __m512 pxLow = _mm512_set1_ps(xLow[i]);
+            const __m512 pyLow = _mm512_set1_ps(yLow[i]);
+            __m512d totalX[2] = { _mm512_setzero_pd(), _mm512_setzero_pd() }, errorX[2] = { totalX[0], totalX[0] };
+            __m512d totalY[2] = { totalX[0], totalX[0] }, errorY[2] = { totalX[0], totalX[0] };
+
+            for (size_t run = jBegin; run < jEnd; run += 16 * MixedRun) {
+                const size_t runEnd = run + 16 * MixedRun < jEnd ? run + 16 * MixedRun : jEnd;
+                __m512 accelerationX = _mm512_setzero_ps();
+                __m512 accelerationY = _mm512_setzero_ps();
+
+                for (size_t j = run; j < runEnd; j += 16) {
+                    // Lanes past runEnd load a mass of 0 and contribute nothing
+                    const size_t count = runEnd - j;
+                    const __mmask16 lanes = count >= 16 ? 0xFFFF : static_cast<__mmask16>((1u << count) - 1);
+
+                    __m512 dx = _mm512_add_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(lanes, x + j), px), _mm512_sub_ps(_mm512_maskz_loadu_ps(lanes, xLow + j), pxLow));
+                    __m512 dy = _mm512_add_ps(_mm512_sub_ps(_mm512_maskz_loadu_ps(lanes, y + j), py), _mm512_sub_ps(_mm512_maskz_loadu_ps(lanes, yLow + j), pyLow));
+                    __m512 mj = _mm512_maskz_loadu_ps(lanes, mass + j);
+                    __m512 r2 = _mm512_fmadd_ps(dx, dx, _mm512_fmadd_ps(dy, dy, eps));
+
+                    __m512 rInv = rsqrtMixedAvx512(r2);
+                    __m512 s = _mm512_mul_ps(mj, _mm512_mul_ps(rInv, _mm512_mul_ps(rInv, rInv)));
+
+                    accelerationX = _mm512_fmadd_ps(s, dx, accelerationX);
+                    accelerationY = _mm512_fmadd_ps(s, dy, accelerationY);
+                }
+
+                flushAvx512(accelerationX, totalX, errorX);
+                flushAvx512(accelerationY, totalY, errorY);
+            }
+
+            const double accelerationX = _mm512_reduce_add_pd(_mm512_add_pd(totalX[0], totalX[1])) - _mm512_reduce_add_pd(_mm512_add_pd(errorX[0], errorX[1]));
+            const double accelerationY = _mm512_reduce_add_pd(_mm512_add_pd(totalY[0], totalY[1])) - _mm512_reduce_add_pd(_mm512_add_pd(errorY[0], errorY[1]));
+            addCompensated(sumX[i - iBegin], compensationX[i - iBegin], accelerationX);
+            addCompensated(sumY[i - iBegin], compensationY[i - iBegin], accelerationY);
+        }
+    }
+
+#else
+
+    // No vector kernels on this platform, supported() reports them unavailable
+    void GravityKernel::avx2(const double* x, const double* y, const double* mass,
+        size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, double eps2,
+        double* sumX, double* sumY)
+    {
+        scalar(x, y, mass, iBegin, iEnd, jBegin, jEnd, eps2, sumX, sumY);
+    }
+
+    void GravityKernel::avx512(const double* x, const double* y, const double* mass,
+        size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, double eps2,
+        double* sumX, double* sumY)
+    {
+        scalar(x, y, mass, iBegin, iEnd, jBegin, jEnd, eps2, sumX, sumY);
+    }
+
+    void GravityKernel::avx2Symmetric(const double* x, const double* y, const double* mass, size_t n,
+        size_t iBegin, size_t iEnd, double eps2, double* accX, double* accY)
+    {
+        scalarSymmetric(x, y, mass, n, iBegin, iEnd, eps2, accX, accY);
+    }
+
+    void GravityKernel::avx512Symmetric(const double* x, const double* y, const double* mass, size_t n,
+        size_t iBegin, size_t iEnd, double eps2, double* accX, double* accY)
+    {
+        scalarSymmetric(x, y, mass, n, iBegin, iEnd, eps2, accX, accY);
+    }
+
+    void GravityKernel::avx2Mixed(const float* x, const float* y, const float* xLow, const float* yLow, const float* mass,
+        size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, float eps2,
+        double* sumX, double* sumY, double* compensationX, double* compensationY)
+    {
+        scalarMixed(x, y, xLow, yLow, mass, iBegin, iEnd, jBegin, jEnd, eps2, sumX, sumY, compensationX, compensationY);
+    }
+
+    void GravityKernel::avx512Mixed(const float* x, const float* y, const float* xLow, const float* yLow, const float* mass,
+        size_t iBegin, size_t iEnd, size_t jBegin, size_t jEnd, float eps2,
+        double* sumX, double* sumY, double* compensationX, double* compensationY)
+    {
+        scalarMixed(x, y, xLow, yLow, mass, iBegin, iEnd, jBegin, jEnd, eps2, sumX, sumY, compensationX, compensationY);
+    }
+
+#endif
+
+} // namespace Physics
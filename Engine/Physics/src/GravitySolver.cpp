@@ -0,0 +1,26 @@
+#include "../headers/GravitySolver.hpp"
+#include "../headers/BodyStorage.hpp"
+
+namespace Physics {
+
+    void GravitySolver::computeActiveAccelerations(BodyStorage& storage, const std::vector<uint32_t>& active, ThreadPool& pool) {
+        if (active.size() == storage.size()) {
+            computeAccelerations(storage, pool);
+            return;
+        }
+
+        // Keep the current accelerations and put back everything but the active bodies
+        std::vector<double> ax = storage.ax;
+        std::vector<double> ay = storage.ay;
+
+        computeAccelerations(storage, pool);
+
+        for (uint32_t i : active) {
+            ax[i] = storage.ax[i];
+            ay[i] = storage.ay[i];
+        }
+        storage.ax.swap(ax);
+        storage.ay.swap(ay);
+    }
+
+} // namespace Physics
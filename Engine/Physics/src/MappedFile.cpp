@@ -0,0 +1,90 @@
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "../headers/MappedFile.hpp"
+
+namespace Physics {
+
+    MappedFile::MappedFile(const std::string& filename) {
+#ifdef _WIN32
+        HANDLE handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (handle == INVALID_HANDLE_VALUE) {
+            throw std::runtime_error("Unable to open " + filename);
+        }
+        file = handle;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(handle, &fileSize)) {
+            close();
+            throw std::runtime_error("Unable to read the size of " + filename);
+        }
+        length = static_cast<size_t>(fileSize.QuadPart);
+
+        if (length > 0) {
+            mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping) data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            if (!data) {
+                close();
+                throw std::runtime_error("Unable to map " + filename);
+            }
+        }
+#else
+        file = ::open(filename.c_str(), O_RDONLY);
+        if (file < 0) {
+            throw std::runtime_error("Unable to open " + filename);
+        }
+
+        struct stat info;
+        if (fstat(file, &info) != 0) {
+            close();
+            throw std::runtime_error("Unable to read the size of " + filename);
+        }
+        length = static_cast<size_t>(info.st_size);
+
+        if (length > 0) {
+            void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file, 0);
+            if (address == MAP_FAILED) {
+                close();
+                throw std::runtime_error("Unable to map " + filename);
+            }
+            data = static_cast<const unsigned char*>(address);
+        }
+#endif
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    void MappedFile::close() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(static_cast<HANDLE>(mapping));
+        if (file) CloseHandle(static_cast<HANDLE>(file));
+        mapping = nullptr;
+        file = nullptr;
+#else
+        if (data) munmap(const_cast<unsigned char*>(data), length);
+        if (file >= 0) ::close(file);
+        file = -1;
+#endif
+        data = nullptr;
+    }
+
+    const unsigned char* MappedFile::begin() const { return data; }
+    const unsigned char* MappedFile::end() const { return data + length; }
+    size_t MappedFile::size() const { return length; }
+
+} // namespace Physics
@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "../headers/ParticleMeshSolver.hpp"
+#include "../headers/BodyStorage.hpp"
+#include "../headers/ThreadPool.hpp"
+#include "../headers/Constants.hpp"
+
+#include "../../Math/headers/Constants.hpp"
+
+namespace Physics {
+
+    // Cells kept free at each edge of the mesh for the assignment stencil
+    static constexpr double MarginCells = 3.0;
+
+    // Rows per deposit stripe. Stripes of one parity never touch the same rows,
+    // so they are filled in parallel, even stripes first, then odd ones.
+    static constexpr size_t StripeRows = 8;
+
+    ParticleMeshSolver::ParticleMeshSolver(size_t gridSize, Assignment assignment, bool shortRange)
+        : gridSize(0), assignment(assignment), shortRange(shortRange), splitScale(1.25), cutoff(4.5), softening(0.0) {
+        setGridSize(gridSize);
+    }
+
+    void ParticleMeshSolver::setGridSize(size_t gridSize) {
+        if (!Math::FFT::isPowerOfTwo(gridSize) || gridSize < 16) {
+            throw std::invalid_argument("Mesh size must be a power of two of at least 16");
+        }
+        this->gridSize = gridSize;
+        fft = std::make_unique<Math::FFT>(2 * gridSize);
+        kernelReady = false;
+    }
+
+    size_t ParticleMeshSolver::getGridSize() const { return gridSize; }
+
+    void ParticleMeshSolver::setAssignment(Assignment assignment) { this->assignment = assignment; }
+    ParticleMeshSolver::Assignment ParticleMeshSolver::getAssignment() const { return assignment; }
+
+    void ParticleMeshSolver::setShortRange(bool enabled, double splitScale, double cutoff) {
+        shortRange = enabled;
+        this->splitScale = splitScale;
+        this->cutoff = cutoff;
+        kernelReady = false;
+    }
+
+    bool ParticleMeshSolver::shortRangeEnabled() const { return shortRange; }
+
+    void ParticleMeshSolver::setSoftening(double softening) {
+        this->softening = softening;
+        kernelReady = false;
+    }
+
+    double ParticleMeshSolver::getSoftening() const { return softening; }
+
+    double ParticleMeshSolver::getCellSize() const { return cellSize; }
+
+    bool ParticleMeshSolver::updateGeometry(const BodyStorage& storage) {
+        const size_t n = storage.size();
+        double minX = storage.x[0], maxX = storage.x[0], minY = storage.y[0], maxY = storage.y[0];
+        for (size_t i = 1; i < n; i++) {
+            minX = std::min(minX, storage.x[i]); maxX = std::max(maxX, storage.x[i]);
+            minY = std::min(minY, storage.y[i]); maxY = std::max(maxY, storage.y[i]);
+        }
+
+        const double span = std::max(maxX - minX, maxY - minY);
+        const double usable = (gridSize - 2.0 * MarginCells) * cellSize;
+
+        // Keep the mesh while every body is inside it and it is not much larger than needed
+        if (kernelReady) {
+            const double low = MarginCells * cellSize;
+            const double high = (gridSize - MarginCells) * cellSize;
+            bool inside = minX - originX >= low && maxX - originX <= high && minY - originY >= low && maxY - originY <= high;
+            if (inside && span >= 0.25 * usable) return false;
+        }
+
+        // 25% headroom so slowly expanding systems do not rebuild every step
+        double extent = span > 0.0 ? 1.25 * span : 1.0;
+        cellSize = extent / (gridSize - 2.0 * MarginCells);
+        originX = 0.5 * (minX + maxX) - 0.5 * gridSize * cellSize;
+        originY = 0.5 * (minY + maxY) - 0.5 * gridSize * cellSize;
+        return true;
+    }
+
+    void ParticleMeshSolver::transform(ThreadPool& pool, bool inverse) {
+        const size_t padded = 2 * gridSize;
+        Complex* data = grid.data();
+
+        pool.parallelFor(padded, 16, [&](size_t begin, size_t end, size_t) {
+            for (size_t row = begin; row < end; row++) {
+                if (inverse) fft->inverse(data + row * padded);
+                else fft->forward(data + row * padded);
+            }
+        });
+
+        pool.parallelFor(padded, 16, [&](size_t begin, size_t end, size_t) {
+            std::vector<Complex> column(padded);
+            for (size_t col = begin; col < end; col++) {
+                for (size_t row = 0; row < padded; row++) column[row] = data[row * padded + col];
+                if (inverse) fft->inverse(column.data());
+                else fft->forward(column.data());
+                for (size_t row = 0; row < padded; row++) data[row * padded + col] = column[row];
+            }
+        });
+    }
+
+    void ParticleMeshSolver::buildKernel(ThreadPool& pool) {
+        const size_t padded = 2 * gridSize;
+        const double eps2 = softening * softening;
+        const double rs = splitScale * cellSize;
+        const double rootPi = std::sqrt(Math::Constants::PI);
+
+        // Acceleration at offset d from a unit mass, -d / |d|^3, stored as Kx + i Ky.
+        // Offsets wrap around the padded grid so the circular convolution is a linear one.
+        grid.assign(padded * padded, Complex(0.0, 0.0));
+        for (size_t row = 0; row < padded; row++) {
+            const long dy = row < gridSize ? long(row) : long(row) - long(padded);
+            for (size_t col = 0; col < padded; col++) {
+                const long dx = col < gridSize ? long(col) : long(col) - long(padded);
+                if ((dx == 0 && dy == 0) || row == gridSize || col == gridSize) continue;
+
+                const double rx = dx * cellSize;
+                const double ry = dy * cellSize;
+                const double r2 = rx * rx + ry * ry;
+                double factor;
+
+                if (shortRange) {
+                    // Long-range part of the Gaussian split, smooth down to r = 0
+                    const double r = std::sqrt(r2);
+                    const double u = r / (2.0 * rs);
+                    factor = (std::erf(u) - r / (rs * rootPi) * std::exp(-u * u)) / (r2 * r);
+                }
+                else {
+                    factor = 1.0 / ((r2 + eps2) * std::sqrt(r2 + eps2));
+                }
+
+                grid[row * padded + col] = Complex(-rx * factor, -ry * factor);
+            }
+        }
+
+        transform(pool, false);
+        kernel = grid;
+        kernelReady = true;
+    }
+
+    int ParticleMeshSolver::weights(double position, double origin, double w[3]) const {
+        // Position in cell units, measured from the center of cell 0
+        const double u = (position - origin) / cellSize - 0.5;
+
+        if (assignment == Assignment::CIC) {
+            const double first = std::floor(u);
+            const double f = u - first;
+            w[0] = 1.0 - f;
+            w[1] = f;
+            w[2] = 0.0;
+            return static_cast<int>(first);
+        }
+
+        const double nearest = std::round(u);
+        const double d = u - nearest;
+        w[0] = 0.5 * (0.5 - d) * (0.5 - d);
+        w[1] = 0.75 - d * d;
+        w[2] = 0.5 * (0.5 + d) * (0.5 + d);
+        return static_cast<int>(nearest) - 1;
+    }
+
+    void ParticleMeshSolver::deposit(const BodyStorage& storage, ThreadPool& pool) {
+        const size_t n = storage.size();
+        const size_t padded = 2 * gridSize;
+        const size_t stripes = (gridSize + StripeRows - 1) / StripeRows;
+
+        // Bin the bodies by the row of their cell
+        rowStart.assign(gridSize + 1, 0);
+        rowBodies.resize(n);
+        std::vector<uint32_t> rowOf(n);
+        for (size_t i = 0; i < n; i++) {
+            long row = static_cast<long>(std::floor((storage.y[i] - originY) / cellSize));
+            rowOf[i] = static_cast<uint32_t>(std::clamp<long>(row, 0, long(gridSize) - 1));
+            rowStart[rowOf[i] + 1]++;
+        }
+        for (size_t r = 0; r < gridSize; r++) rowStart[r + 1] += rowStart[r];
+        std::vector<uint32_t> cursor(rowStart.begin(), rowStart.end() - 1);
+        for (size_t i = 0; i < n; i++) rowBodies[cursor[rowOf[i]]++] = static_cast<uint32_t>(i);
+
+        grid.assign(padded * padded, Complex(0.0, 0.0));
+
+        for (size_t parity = 0; parity < 2; parity++) {
+            const size_t count = (stripes + 1 - parity) / 2;
+            pool.run(count, [&](size_t task, size_t) {
+                const size_t stripe = 2 * task + parity;
+                const size_t firstRow = stripe * StripeRows;
+                const size_t lastRow = std::min(firstRow + StripeRows, gridSize);
+
+                for (size_t k = rowStart[firstRow]; k < rowStart[lastRow]; k++) {
+                    const uint32_t i = rowBodies[k];
+                    double wx[3], wy[3];
+                    int cx = weights(storage.x[i], originX, wx);
+                    int cy = weights(storage.y[i], originY, wy);
+
+                    for (int b = 0; b < 3; b++) {
+                        for (int a = 0; a < 3; a++) {
+                            double w = wx[a] * wy[b];
+                            if (w == 0.0) continue;
+                            grid[size_t(cy + b) * padded + size_t(cx + a)] += storage.mass[i] * w;
+                        }
+                    }
+                }
+            });
+        }
+    }
+
+    void ParticleMeshSolver::interpolate(BodyStorage& storage, ThreadPool& pool) const {
+        const size_t padded = 2 * gridSize;
+
+        pool.parallelFor(storage.size(), 1024, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                double wx[3], wy[3];
+                int cx = weights(storage.x[i], originX, wx);
+                int cy = weights(storage.y[i], originY, wy);
+
+                double accelerationX = 0.0, accelerationY = 0.0;
+                for (int b = 0; b < 3; b++) {
+                    for (int a = 0; a < 3; a++) {
+                        double w = wx[a] * wy[b];
+                        if (w == 0.0) continue;
+                        const Complex& value = grid[size_t(cy + b) * padded + size_t(cx + a)];
+                        accelerationX += w * value.real();
+                        accelerationY += w * value.imag();
+                    }
+                }
+
+                storage.ax[i] = Constants::GRAVITATIONAL_CONSTANT * accelerationX;
+                storage.ay[i] = Constants::GRAVITATIONAL_CONSTANT * accelerationY;
+            }
+        });
+    }
+
+    void ParticleMeshSolver::addShortRange(BodyStorage& storage, ThreadPool& pool) {
+        const size_t n = storage.size();
+        const double rs = splitScale * cellSize;
+        const double radius = cutoff * rs;
+        const double radius2 = radius * radius;
+        const double eps2 = softening * softening;
+        const double rootPi = std::sqrt(Math::Constants::PI);
+
+        // Chaining mesh with cells at least as large as the cutoff
+        const double extent = gridSize * cellSize;
+        const size_t cells = std::max<size_t>(1, static_cast<size_t>(extent / radius));
+        const double chainSize = extent / cells;
+
+        auto cellOf = [&](double position, double origin) {
+            long c = static_cast<long>(std::floor((position - origin) / chainSize));
+            return static_cast<size_t>(std::clamp<long>(c, 0, long(cells) - 1));
+        };
+
+        chainStart.assign(cells * cells + 1, 0);
+        chainBodies.resize(n);
+        std::vector<uint32_t> chainOf(n);
+        for (size_t i = 0; i < n; i++) {
+            chainOf[i] = static_cast<uint32_t>(cellOf(storage.y[i], originY) * cells + cellOf(storage.x[i], originX));
+            chainStart[chainOf[i] + 1]++;
+        }
+        for (size_t c = 0; c < cells * cells; c++) chainStart[c + 1] += chainStart[c];
+        std::vector<uint32_t> cursor(chainStart.begin(), chainStart.end() - 1);
+        for (size_t i = 0; i < n; i++) chainBodies[cursor[chainOf[i]]++] = static_cast<uint32_t>(i);
+
+        pool.parallelFor(n, 256, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                const double px = storage.x[i], py = storage.y[i];
+                const long cx = long(chainOf[i] % cells), cy = long(chainOf[i] / cells);
+                double accelerationX = 0.0, accelerationY = 0.0;
+
+                for (long ny = std::max(0L, cy - 1); ny <= std::min(long(cells) - 1, cy + 1); ny++) {
+                    for (long nx = std::max(0L, cx - 1); nx <= std::min(long(cells) - 1, cx + 1); nx++) {
+                        const size_t c = size_t(ny) * cells + size_t(nx);
+                        for (uint32_t k = chainStart[c]; k < chainStart[c + 1]; k++) {
+                            const uint32_t j = chainBodies[k];
+                            const double dx = storage.x[j] - px;
+                            const double dy = storage.y[j] - py;
+                            const double r2 = dx * dx + dy * dy;
+                            if (r2 == 0.0 || r2 >= radius2) continue;
+
+                            // Short-range part of the split, erfc(u) + 2u / sqrt(pi) exp(-u^2)
+                            const double r = std::sqrt(r2);
+                            const double u = r / (2.0 * rs);
+                            const double split = std::erfc(u) + r / (rs * rootPi) * std::exp(-u * u);
+                            const double soft = r2 + eps2;
+                            const double s = storage.mass[j] * split / (soft * std::sqrt(soft));
+                            accelerationX += s * dx;
+                            accelerationY += s * dy;
+                        }
+                    }
+                }
+
+                storage.ax[i] += Constants::GRAVITATIONAL_CONSTANT * accelerationX;
+                storage.ay[i] += Constants::GRAVITATIONAL_CONSTANT * accelerationY;
+            }
+        });
+    }
+
+    void ParticleMeshSolver::computeAccelerations(BodyStorage& storage, ThreadPool& pool) {
+        if (storage.size() == 0) return;
+
+        if (updateGeometry(storage) || !kernelReady) buildKernel(pool);
+
+        deposit(storage, pool);
+        transform(pool, false);
+
+        // Convolution: one complex product gives both components
+        const size_t total = grid.size();
+        pool.parallelFor(total, 16384, [&](size_t begin, size_t end, size_t) {
+            for (size_t k = begin; k < end; k++) {
+                const Complex a = grid[k], b = kernel[k];
+                grid[k] = Complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+            }
+        });
+
+        transform(pool, true);
+        interpolate(storage, pool);
+
+        if (shortRange) addShortRange(storage, pool);
+    }
+
+} // namespace Physics
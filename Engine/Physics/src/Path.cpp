@@ -1,29 +1,89 @@
+#include <algorithm>
+#include <stdexcept>
 
 #include "../headers/Path.hpp"
 
-#include "../../Math/headers/Vector.hpp"
+#include "../../Math/headers/Operation.hpp"
 
 namespace Physics {
 
+    Path::Path(size_t capacity, double minDistance, bool downsample)
+        : points(capacity), minDistance(minDistance), downsample(downsample) {
+        if (capacity < 4) {
+            throw std::invalid_argument("Path capacity must be at least 4");
+        }
+    }
+
     void Path::insert(const Math::Vector& v) {
-        size_t hash = v.hash();
+        if (count > 0 && Math::Operation::SquaredDistance(back(), v) < minDistance * minDistance) return;
 
-        if (hashToVector.find(hash) == hashToVector.end()) {
-            hashList.push_back(hash);
-            hashToVector[hash] = v;
+        if (count == points.size()) {
+            if (downsample) {
+                compact();
+            }
+            else {
+                // Overwrite the oldest point
+                head = (head + 1) % points.size();
+                count--;
+                revision++;
+            }
         }
+
+        points[(head + count) % points.size()] = v;
+        count++;
+    }
+
+    void Path::compact() {
+        // Make the buffer chronological, then keep every second point of the older half
+        std::rotate(points.begin(), points.begin() + head, points.end());
+        head = 0;
+
+        const size_t half = count / 2;
+        size_t kept = 0;
+        for (size_t i = 0; i < half; i += 2) points[kept++] = points[i];
+        for (size_t i = half; i < count; i++) points[kept++] = points[i];
+        count = kept;
+        revision++;
     }
 
-    Math::Vector Path::get(int i) const {
-        if (i < 0 || i >= hashList.size()) {
+    const Math::Vector& Path::get(int i) const {
+        if (i < 0 || static_cast<size_t>(i) >= count) {
             throw std::out_of_range("Index out of range");
         }
-        size_t hash = hashList[i];
+        return points[(head + i) % points.size()];
+    }
 
-        return hashToVector.at(hash);
+    const Math::Vector& Path::back() const {
+        if (count == 0) {
+            throw std::out_of_range("Path is empty");
+        }
+        return points[(head + count - 1) % points.size()];
     }
 
     size_t Path::getSize() const {
-        return hashList.size();
+        return count;
+    }
+
+    size_t Path::getCapacity() const {
+        return points.size();
+    }
+
+    size_t Path::getRevision() const {
+        return revision;
+    }
+
+    void Path::setMinDistance(double distance) {
+        minDistance = distance;
     }
+
+    double Path::getMinDistance() const {
+        return minDistance;
+    }
+
+    void Path::clear() {
+        head = 0;
+        count = 0;
+        revision++;
+    }
+
 } // namespace Physics
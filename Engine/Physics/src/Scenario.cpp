@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "../headers/Scenario.hpp"
+#include "../headers/World.hpp"
+#include "../headers/MappedFile.hpp"
+#include "../headers/ThreadPool.hpp"
+
+namespace Physics {
+
+    // Columns of a scenario row, the radius column is optional
+    static constexpr size_t ScenarioColumns = 5;
+    static constexpr size_t MaxScenarioColumns = 6;
+
+    // Files are split into chunks of at least this many bytes, parsed in parallel
+    static constexpr size_t MinChunkBytes = size_t(1) << 20;
+
+    static std::runtime_error parseError(const std::string& filename, size_t line, const std::string& message) {
+        return std::runtime_error(filename + ":" + std::to_string(line) + ": " + message);
+    }
+
+    static const char* skipBlanks(const char* cursor, const char* end) {
+        while (cursor < end && (*cursor == ' ' || *cursor == '\t')) cursor++;
+        return cursor;
+    }
+
+    static const char* lineEnd(const char* cursor, const char* end) {
+        const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+        return newline ? newline : end;
+    }
+
+    // Rows are lines with anything but blanks on them
+    static bool isBlank(const char* begin, const char* end) {
+        const char* cursor = skipBlanks(begin, end);
+        return cursor == end || (*cursor == '\r' && cursor + 1 == end);
+    }
+
+    // Parse one row into values, returns an empty string or the reason it failed
+    static std::string parseRow(const char* cursor, const char* end, double* values) {
+        if (end > cursor && end[-1] == '\r') end--;
+        values[ScenarioColumns] = 0.0; // No radius column
+
+        for (size_t column = 0; column < MaxScenarioColumns; column++) {
+            cursor = skipBlanks(cursor, end);
+
+            // from_chars rejects a leading '+', which strtod used to accept
+            if (cursor < end && *cursor == '+') cursor++;
+            auto [next, error] = std::from_chars(cursor, end, values[column]);
+            if (error == std::errc::result_out_of_range) {
+                return "number out of range in column " + std::to_string(column + 1);
+            }
+            if (error != std::errc()) {
+                return "expected a number in column " + std::to_string(column + 1);
+            }
+
+            cursor = skipBlanks(next, end);
+            if (cursor == end && column + 1 >= ScenarioColumns) break;
+            if (cursor == end || (*cursor != ',' && column + 1 < ScenarioColumns)) {
+                return "expected " + std::to_string(ScenarioColumns) + " columns";
+            }
+            if (*cursor != ',' || column + 1 == MaxScenarioColumns) {
+                return "unexpected text after column " + std::to_string(column + 1);
+            }
+            cursor++;
+        }
+        return std::string();
+    }
+
+    size_t Scenario::load(const std::string& filename, World& world) {
+        MappedFile file(filename);
+        const char* begin = reinterpret_cast<const char*>(file.begin());
+        const char* end = reinterpret_cast<const char*>(file.end());
+
+        // Skip the header line, which may be descriptive or empty
+        const char* body = begin ? lineEnd(begin, end) : end;
+        if (body < end) body++;
+
+        // Split at line starts so every chunk holds whole lines
+        ThreadPool pool(world.getThreadCount());
+        const size_t bytes = static_cast<size_t>(end - body);
+        const size_t chunkBytes = std::max(MinChunkBytes, bytes / (pool.size() * 4) + 1);
+
+        std::vector<const char*> chunkStarts;
+        for (const char* cursor = body; cursor < end; ) {
+            chunkStarts.push_back(cursor);
+            if (static_cast<size_t>(end - cursor) <= chunkBytes) break;
+            cursor = lineEnd(cursor + chunkBytes, end);
+            if (cursor < end) cursor++;
+        }
+        const size_t chunks = chunkStarts.size();
+        chunkStarts.push_back(end);
+
+        // First pass counts lines and rows, so every chunk knows where its rows go
+        // and which line number it starts at
+        std::vector<size_t> lines(chunks + 1, 0), rows(chunks + 1, 0);
+        pool.run(chunks, [&](size_t chunk, size_t) {
+            const char* chunkEnd = chunkStarts[chunk + 1];
+            for (const char* cursor = chunkStarts[chunk]; cursor < chunkEnd; ) {
+                const char* next = lineEnd(cursor, chunkEnd);
+                lines[chunk + 1]++;
+                if (!isBlank(cursor, next)) rows[chunk + 1]++;
+                if (next == chunkEnd) break;
+                cursor = next + 1;
+            }
+        });
+        lines[0] = 2; // The first row is on line 2
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            lines[chunk + 1] += lines[chunk];
+            rows[chunk + 1] += rows[chunk];
+        }
+
+        // Second pass parses straight into the arrays, keeping the first error of each chunk
+        BodyStorage states;
+        const size_t n = rows[chunks];
+        states.resize(n);
+
+        std::vector<size_t> errorLines(chunks, 0);
+        std::vector<std::string> errors(chunks);
+        pool.run(chunks, [&](size_t chunk, size_t) {
+            size_t line = lines[chunk];
+            size_t row = rows[chunk];
+            const char* chunkEnd = chunkStarts[chunk + 1];
+            for (const char* cursor = chunkStarts[chunk]; cursor < chunkEnd; line++) {
+                const char* next = lineEnd(cursor, chunkEnd);
+                if (!isBlank(cursor, next)) {
+                    // Parse mass, distance, and velocity
+                    double values[MaxScenarioColumns];
+                    std::string error = parseRow(cursor, next, values);
+                    if (!error.empty()) {
+                        errorLines[chunk] = line;
+                        errors[chunk] = std::move(error);
+                        return;
+                    }
+
+                    states.mass[row] = values[0];
+                    states.invMass[row] = 1.0 / values[0];
+                    states.x[row] = values[1];
+                    states.y[row] = values[2];
+                    states.vx[row] = values[3];
+                    states.vy[row] = values[4];
+                    states.radius[row] = values[5];
+                    row++;
+                }
+                if (next == chunkEnd) break;
+                cursor = next + 1;
+            }
+        });
+
+        // Chunks are in file order, so the first failing chunk has the first error
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            if (!errors[chunk].empty()) throw parseError(filename, errorLines[chunk], errors[chunk]);
+        }
+
+        // Only touch the world once the whole file parsed
+        world.addBodies(states);
+        return n;
+    }
+
+    void Scenario::save(const std::string& filename, const World& world) {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("Unable to write scenario " + filename);
+        }
+
+        // Enough digits to read back the same doubles
+        file.precision(17);
+        // The radius column is only written when some body has a radius
+        const BodyStorage& storage = world.getStorage();
+        const bool radius = std::any_of(storage.radius.begin(), storage.radius.end(), [](double r) { return r != 0.0; });
+        file << "mass,distanceX,distanceY,velocityX,velocityY" << (radius ? ",radius\n" : "\n");
+
+        for (size_t i = 0; i < storage.size(); i++) {
+            file << storage.mass[i] << ',' << storage.x[i] << ',' << storage.y[i] << ','
+                << storage.vx[i] << ',' << storage.vy[i];
+            if (radius) file << ',' << storage.radius[i];
+            file << '\n';
+        }
+
+        if (!file) {
+            throw std::runtime_error("Failed writing scenario " + filename);
+        }
+    }
+
+} // namespace Physics
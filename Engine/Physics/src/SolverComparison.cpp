@@ -0,0 +1,74 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+
+#include "../headers/SolverComparison.hpp"
+#include "../headers/GravitySolver.hpp"
+#include "../headers/BodyStorage.hpp"
+#include "../headers/ThreadPool.hpp"
+
+namespace Physics {
+
+    // Wall time of one evaluation
+    static double timeSolver(GravitySolver& solver, BodyStorage& storage, ThreadPool& pool) {
+        auto start = std::chrono::steady_clock::now();
+        solver.computeAccelerations(storage, pool);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double SolverComparison::speedup() const {
+        return candidateSeconds > 0.0 ? referenceSeconds / candidateSeconds : 0.0;
+    }
+
+    std::string SolverComparison::toString() const {
+        std::ostringstream oss;
+        oss << "N = " << bodies
+            << std::fixed << std::setprecision(4)
+            << ", reference " << referenceSeconds << " s"
+            << ", candidate " << candidateSeconds << " s"
+            << std::setprecision(2) << " (x" << speedup() << ")"
+            << std::scientific << std::setprecision(2)
+            << ", relative error max " << maxRelativeError
+            << " rms " << rmsRelativeError
+            << " median " << medianRelativeError;
+        return oss.str();
+    }
+
+    SolverComparison SolverComparison::compare(GravitySolver& reference, GravitySolver& candidate,
+        const BodyStorage& storage, ThreadPool& pool)
+    {
+        SolverComparison result;
+        result.bodies = storage.size();
+
+        BodyStorage expected = storage;
+        BodyStorage actual = storage;
+        result.referenceSeconds = timeSolver(reference, expected, pool);
+        result.candidateSeconds = timeSolver(candidate, actual, pool);
+
+        std::vector<double> errors;
+        errors.reserve(result.bodies);
+        double sumSquares = 0.0;
+
+        for (size_t i = 0; i < result.bodies; i++) {
+            double magnitude = std::hypot(expected.ax[i], expected.ay[i]);
+            if (magnitude == 0.0) continue;
+
+            double error = std::hypot(actual.ax[i] - expected.ax[i], actual.ay[i] - expected.ay[i]) / magnitude;
+            errors.push_back(error);
+            sumSquares += error * error;
+            result.maxRelativeError = std::max(result.maxRelativeError, error);
+        }
+
+        if (!errors.empty()) {
+            result.rmsRelativeError = std::sqrt(sumSquares / errors.size());
+            std::nth_element(errors.begin(), errors.begin() + errors.size() / 2, errors.end());
+            result.medianRelativeError = errors[errors.size() / 2];
+        }
+
+        return result;
+    }
+
+} // namespace Physics
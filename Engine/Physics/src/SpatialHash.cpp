@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cmath>
+
+#include "../headers/SpatialHash.hpp"
+#include "../headers/ThreadPool.hpp"
+
+#include "../../Math/headers/BoundingBox.hpp"
+#include "../../Math/headers/Vector.hpp"
+
+namespace Physics {
+
+    // Participants queried per task
+    static constexpr size_t QueryGrain = 2048;
+
+    // Bodies with a radius above this multiple of the mean are tested against everyone
+    static constexpr double LargeRadiusFactor = 4.0;
+
+    // Cell coordinates are clamped, far apart bodies may share a cell but are still tested exactly
+    static constexpr double MaxCellCoordinate = 1099511627776.0; // 2^40
+
+    static uint32_t hashCell(int64_t x, int64_t y, uint32_t mask) {
+        uint64_t h = static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(y) * 0xC2B2AE3D27D4EB4Full;
+        h ^= h >> 29;
+        return static_cast<uint32_t>(h) & mask;
+    }
+
+    static bool overlap(const BodyStorage& storage, uint32_t i, uint32_t j) {
+        const double dx = storage.x[j] - storage.x[i];
+        const double dy = storage.y[j] - storage.y[i];
+        const double reach = storage.radius[i] + storage.radius[j];
+        return dx * dx + dy * dy < reach * reach;
+    }
+
+    void SpatialHash::findPairs(const BodyStorage& storage, ThreadPool& pool, std::vector<Pair>& pairs) {
+        pairs.clear();
+        const size_t n = storage.size();
+
+        participants.clear();
+        double radiusSum = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            if (storage.radius[i] > 0.0) {
+                participants.push_back(static_cast<uint32_t>(i));
+                radiusSum += storage.radius[i];
+            }
+        }
+        if (participants.size() < 2) return;
+
+        // Separate the outsized bodies, the cells fit the largest of the others
+        const double largeRadius = LargeRadiusFactor * radiusSum / participants.size();
+        isLarge.assign(n, 0);
+        large.clear();
+        double maxRadius = 0.0;
+        for (uint32_t i : participants) {
+            if (storage.radius[i] > largeRadius) {
+                isLarge[i] = 1;
+                large.push_back(i);
+            }
+            else {
+                maxRadius = std::max(maxRadius, storage.radius[i]);
+            }
+        }
+        cellSize = 2.0 * maxRadius;
+
+        // Cells are counted from the corner of the bodies' extent
+        Math::BoundingBox extent;
+        for (uint32_t i : participants) extent.expand(Math::Vector(storage.x[i], storage.y[i]));
+        const double originX = extent.min.x, originY = extent.min.y;
+
+        size_t buckets = 1;
+        while (buckets < 2 * participants.size()) buckets <<= 1;
+        const uint32_t mask = static_cast<uint32_t>(buckets - 1);
+
+        cellX.resize(n);
+        cellY.resize(n);
+        bucketOf.resize(participants.size());
+        pool.parallelFor(participants.size(), QueryGrain, [&](size_t begin, size_t end, size_t) {
+            for (size_t k = begin; k < end; k++) {
+                const uint32_t i = participants[k];
+                cellX[i] = static_cast<int64_t>(std::min((storage.x[i] - originX) / cellSize, MaxCellCoordinate));
+                cellY[i] = static_cast<int64_t>(std::min((storage.y[i] - originY) / cellSize, MaxCellCoordinate));
+                bucketOf[k] = hashCell(cellX[i], cellY[i], mask);
+            }
+        });
+
+        // Counting sort of the small participants by bucket
+        bucketStart.assign(buckets + 1, 0);
+        for (size_t k = 0; k < participants.size(); k++) {
+            if (!isLarge[participants[k]]) bucketStart[bucketOf[k] + 1]++;
+        }
+        for (size_t b = 0; b < buckets; b++) bucketStart[b + 1] += bucketStart[b];
+
+        sorted.resize(bucketStart[buckets]);
+        bucketCursor.assign(bucketStart.begin(), bucketStart.end() - 1);
+        for (size_t k = 0; k < participants.size(); k++) {
+            if (!isLarge[participants[k]]) sorted[bucketCursor[bucketOf[k]]++] = participants[k];
+        }
+
+        threadPairs.resize(pool.size());
+        for (auto& found : threadPairs) found.clear();
+
+        // Each small body meets the small bodies after it in the 3 x 3 block of cells around it
+        pool.parallelFor(participants.size(), QueryGrain, [&](size_t begin, size_t end, size_t thread) {
+            std::vector<Pair>& found = threadPairs[thread];
+            for (size_t k = begin; k < end; k++) {
+                const uint32_t i = participants[k];
+                if (isLarge[i]) continue;
+
+                for (int64_t dy = -1; dy <= 1; dy++) {
+                    for (int64_t dx = -1; dx <= 1; dx++) {
+                        const int64_t cx = cellX[i] + dx, cy = cellY[i] + dy;
+                        const uint32_t bucket = hashCell(cx, cy, mask);
+                        for (uint32_t s = bucketStart[bucket]; s < bucketStart[bucket + 1]; s++) {
+                            const uint32_t j = sorted[s];
+                            // Other cells hashed into the bucket are skipped, so no pair is found twice
+                            if (j > i && cellX[j] == cx && cellY[j] == cy && overlap(storage, i, j)) {
+                                found.emplace_back(i, j);
+                            }
+                        }
+                    }
+                }
+            }
+        });
+
+        // Large bodies against every participant, large pairs only once
+        if (!large.empty()) {
+            pool.parallelFor(participants.size(), QueryGrain, [&](size_t begin, size_t end, size_t thread) {
+                std::vector<Pair>& found = threadPairs[thread];
+                for (size_t k = begin; k < end; k++) {
+                    const uint32_t j = participants[k];
+                    for (uint32_t i : large) {
+                        if (i == j || (isLarge[j] && j < i)) continue;
+                        if (overlap(storage, i, j)) found.emplace_back(std::min(i, j), std::max(i, j));
+                    }
+                }
+            });
+        }
+
+        for (const auto& found : threadPairs) pairs.insert(pairs.end(), found.begin(), found.end());
+        std::sort(pairs.begin(), pairs.end());
+    }
+
+    double SpatialHash::getCellSize() const {
+        return cellSize;
+    }
+
+} // namespace Physics
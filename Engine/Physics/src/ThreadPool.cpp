@@ -0,0 +1,109 @@
+#include <algorithm>
+
+#include "../headers/ThreadPool.hpp"
+
+namespace Physics {
+
+    ThreadPool::ThreadPool(size_t threads) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        for (size_t t = 1; t < threads; t++) {
+            workers.emplace_back(&ThreadPool::workerLoop, this, t);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+    }
+
+    size_t ThreadPool::size() const {
+        return workers.size() + 1;
+    }
+
+    void ThreadPool::drain(size_t thread) {
+        for (size_t task = nextTask.fetch_add(1); task < taskCount; task = nextTask.fetch_add(1)) {
+            try {
+                (*job)(task, thread);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+        }
+    }
+
+    void ThreadPool::workerLoop(size_t thread) {
+        size_t seen = 0;
+
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+
+            drain(thread);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                busyWorkers--;
+            }
+            finished.notify_one();
+        }
+    }
+
+    void ThreadPool::run(size_t tasks, const Task& task) {
+        if (tasks == 0) return;
+
+        // Nothing to share, run on the caller
+        if (workers.empty() || tasks == 1) {
+            for (size_t i = 0; i < tasks; i++) task(i, 0);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &task;
+            taskCount = tasks;
+            nextTask = 0;
+            busyWorkers = workers.size();
+            error = nullptr;
+            generation++;
+        }
+        wake.notify_all();
+
+        drain(0);
+
+        std::exception_ptr failure;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [&] { return busyWorkers == 0; });
+            job = nullptr;
+            failure = error;
+        }
+
+        if (failure) std::rethrow_exception(failure);
+    }
+
+    void ThreadPool::parallelFor(size_t count, size_t grain, const RangeTask& task) {
+        grain = std::max<size_t>(grain, 1);
+        size_t chunks = (count + grain - 1) / grain;
+
+        run(chunks, [&](size_t chunk, size_t thread) {
+            size_t begin = chunk * grain;
+            task(begin, std::min(begin + grain, count), thread);
+        });
+    }
+
+} // namespace Physics
@@ -0,0 +1,112 @@
+#include <cstring>
+#include <stdexcept>
+
+#include "../headers/TrajectoryReader.hpp"
+#include "../headers/TrajectoryFormat.hpp"
+
+namespace Physics {
+
+    using namespace TrajectoryFormat;
+
+    TrajectoryReader::TrajectoryReader(const std::string& filename) : filename(filename) {
+        file.open(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Unable to open trajectory " + filename);
+        }
+
+        file.seekg(0, std::ios::end);
+        fileSize = static_cast<uint64_t>(file.tellg());
+        file.seekg(0, std::ios::beg);
+
+        uint8_t header[FileHeaderSize];
+        file.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!file || std::memcmp(header, FileMagic, sizeof(FileMagic)) != 0) {
+            throw std::runtime_error("Trajectory " + filename + " has no valid header");
+        }
+
+        uint32_t version = getU32(header + 8);
+        if (version == 0 || version > Version) {
+            throw std::runtime_error("Trajectory " + filename + " has unsupported version " + std::to_string(version));
+        }
+
+        positionQuantum = getF64(header + 16);
+        velocityQuantum = getF64(header + 24);
+    }
+
+    bool TrajectoryReader::readChunk() {
+        uint8_t header[ChunkHeaderSize];
+        file.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (file.gcount() == 0) return false;
+        if (!file || std::memcmp(header, ChunkMagic, sizeof(ChunkMagic)) != 0) {
+            throw std::runtime_error("Trajectory " + filename + " has a corrupt chunk header");
+        }
+
+        // Check the claimed size against the rest of the file before allocating for it
+        const uint64_t size = getU64(header + 8);
+        if (size > fileSize - static_cast<uint64_t>(file.tellg())) {
+            throw std::runtime_error("Trajectory " + filename + " is truncated");
+        }
+
+        framesLeft = getU32(header + 4);
+        chunk.resize(size);
+        file.read(reinterpret_cast<char*>(chunk.data()), chunk.size());
+        if (!file) {
+            throw std::runtime_error("Trajectory " + filename + " is truncated");
+        }
+
+        offset = 0;
+        return true;
+    }
+
+    bool TrajectoryReader::next(Frame& frame) {
+        while (framesLeft == 0) {
+            if (!readChunk()) return false;
+        }
+
+        const uint8_t* in = chunk.data() + offset;
+        const uint8_t* end = chunk.data() + chunk.size();
+        auto corrupt = [&]() {
+            return std::runtime_error("Trajectory " + filename + " has a corrupt frame");
+        };
+
+        uint64_t step, n;
+        if (!getVarint(in, end, step) || end - in < 8) throw corrupt();
+        frame.step = step;
+        frame.time = getF64(in);
+        in += 8;
+        if (!getVarint(in, end, n) || in >= end) throw corrupt();
+        const bool keyframe = (*in++ & Keyframe) != 0;
+
+        // Every value takes at least one byte, so a count the chunk cannot hold is corrupt.
+        // Checked before sizing anything from it, which also keeps 4 * n from overflowing.
+        if (n > static_cast<uint64_t>(end - in) / 4) throw corrupt();
+
+        if (!keyframe && previous.size() != 4 * n) throw corrupt();
+        previous.resize(4 * n);
+
+        std::vector<double>* arrays[4] = { &frame.x, &frame.y, &frame.vx, &frame.vy };
+        const double quanta[4] = { positionQuantum, positionQuantum, velocityQuantum, velocityQuantum };
+
+        for (size_t a = 0; a < 4; a++) {
+            arrays[a]->resize(n);
+            double* values = arrays[a]->data();
+            int64_t* last = previous.data() + a * n;
+
+            for (size_t i = 0; i < n; i++) {
+                uint64_t encoded;
+                if (!getVarint(in, end, encoded)) throw corrupt();
+                int64_t q = unzigzag(encoded) + (keyframe ? 0 : last[i]);
+                last[i] = q;
+                values[i] = static_cast<double>(q) * quanta[a];
+            }
+        }
+
+        offset = in - chunk.data();
+        framesLeft--;
+        return true;
+    }
+
+    double TrajectoryReader::getPositionQuantum() const { return positionQuantum; }
+    double TrajectoryReader::getVelocityQuantum() const { return velocityQuantum; }
+
+} // namespace Physics
@@ -0,0 +1,211 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "../headers/TrajectoryWriter.hpp"
+#include "../headers/TrajectoryFormat.hpp"
+#include "../headers/World.hpp"
+
+namespace Physics {
+
+    using namespace TrajectoryFormat;
+
+    // Quantized values are kept within +-2^62 so deltas never overflow
+    static constexpr double QuantizedLimit = 4611686018427387904.0;
+
+    // Longest LEB128 encoding of a 64 bit value
+    static constexpr size_t MaxVarintBytes = 10;
+
+    // Round a value already divided by its quantum
+    static int64_t quantize(double scaled) {
+        if (!(scaled == scaled)) return 0; // NaN
+        if (scaled > QuantizedLimit) scaled = QuantizedLimit;
+        if (scaled < -QuantizedLimit) scaled = -QuantizedLimit;
+
+        // Round half away from zero, cheaper than a call to nearbyint
+        return static_cast<int64_t>(scaled + (scaled < 0.0 ? -0.5 : 0.5));
+    }
+
+    TrajectoryWriter::TrajectoryWriter(const std::string& filename)
+        : TrajectoryWriter(filename, Options()) {}
+
+    TrajectoryWriter::TrajectoryWriter(const std::string& filename, const Options& options) : options(options) {
+        if (options.decimation == 0 || options.framesPerChunk == 0) {
+            throw std::invalid_argument("Trajectory decimation and chunk size must be positive");
+        }
+        if (!(options.positionQuantum > 0.0) || !(options.velocityQuantum > 0.0)) {
+            throw std::invalid_argument("Trajectory quanta must be positive");
+        }
+
+        file.open(filename, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Unable to write trajectory " + filename);
+        }
+
+        std::vector<uint8_t> header(FileMagic, FileMagic + sizeof(FileMagic));
+        putU32(header, Version);
+        putU32(header, 0);
+        putF64(header, options.positionQuantum);
+        putF64(header, options.velocityQuantum);
+        file.write(reinterpret_cast<const char*>(header.data()), header.size());
+        bytesWritten = header.size();
+
+        writer = std::thread(&TrajectoryWriter::writerLoop, this);
+    }
+
+    TrajectoryWriter::~TrajectoryWriter() {
+        try {
+            close();
+        }
+        catch (...) {
+            // Destructors cannot report errors, call close to see them
+        }
+    }
+
+    void TrajectoryWriter::onStep(const World& world) {
+        if (++steps % options.decimation != 0) return;
+        record(world);
+    }
+
+    void TrajectoryWriter::record(const World& world) {
+        rethrow();
+        if (full || !writer.joinable()) return;
+
+        // Copy on the step thread, everything else happens on the writer
+        const BodyStorage& storage = world.getStorage();
+        filling.step = steps;
+        filling.time = world.getTime();
+        filling.x = storage.x;
+        filling.y = storage.y;
+        filling.vx = storage.vx;
+        filling.vy = storage.vy;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]() { return !queuedReady || error; });
+            if (error) std::rethrow_exception(error);
+
+            std::swap(filling, queued);
+            queuedReady = true;
+        }
+        changed.notify_all();
+    }
+
+    void TrajectoryWriter::close() {
+        if (writer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            changed.notify_all();
+            writer.join();
+            file.close();
+        }
+        rethrow();
+    }
+
+    void TrajectoryWriter::rethrow() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (error) std::rethrow_exception(error);
+    }
+
+    void TrajectoryWriter::writerLoop() {
+        try {
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&]() { return queuedReady || stopping; });
+                    if (!queuedReady) break;
+
+                    std::swap(queued, current);
+                    queuedReady = false;
+                }
+                changed.notify_all();
+
+                if (!full) encode(current);
+            }
+            flushChunk();
+            file.flush();
+            if (!file) throw std::runtime_error("Failed writing trajectory");
+        }
+        catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                error = std::current_exception();
+            }
+            changed.notify_all();
+        }
+    }
+
+    void TrajectoryWriter::encode(const Frame& frame) {
+        const size_t n = frame.x.size();
+
+        // A change in the number of bodies starts a new chunk, which starts with a keyframe
+        if (previous.size() != 4 * n && chunkFrames > 0) flushChunk();
+        const bool keyframe = chunkFrames == 0;
+        previous.resize(4 * n);
+
+        putVarint(chunk, frame.step);
+        putF64(chunk, frame.time);
+        putVarint(chunk, n);
+        chunk.push_back(keyframe ? Keyframe : 0);
+
+        const std::vector<double>* arrays[4] = { &frame.x, &frame.y, &frame.vx, &frame.vy };
+        const double quanta[4] = { options.positionQuantum, options.positionQuantum, options.velocityQuantum, options.velocityQuantum };
+
+        // Varints are written through a raw cursor into space reserved for the worst case
+        size_t used = chunk.size();
+        chunk.resize(used + 4 * n * MaxVarintBytes);
+        uint8_t* out = chunk.data() + used;
+
+        for (size_t a = 0; a < 4; a++) {
+            const double* values = arrays[a]->data();
+            const double scale = 1.0 / quanta[a];
+            int64_t* last = previous.data() + a * n;
+
+            for (size_t i = 0; i < n; i++) {
+                int64_t q = quantize(values[i] * scale);
+                uint64_t value = zigzag(keyframe ? q : q - last[i]);
+                last[i] = q;
+
+                while (value >= 0x80) {
+                    *out++ = static_cast<uint8_t>(value) | 0x80;
+                    value >>= 7;
+                }
+                *out++ = static_cast<uint8_t>(value);
+            }
+        }
+        chunk.resize(out - chunk.data());
+
+        if (++chunkFrames == options.framesPerChunk) flushChunk();
+    }
+
+    void TrajectoryWriter::flushChunk() {
+        if (chunkFrames == 0) return;
+
+        std::vector<uint8_t> header(ChunkMagic, ChunkMagic + sizeof(ChunkMagic));
+        putU32(header, chunkFrames);
+        putU64(header, chunk.size());
+
+        const uint64_t size = header.size() + chunk.size();
+        if (options.maxBytes && bytesWritten + size > options.maxBytes) {
+            // Out of budget: drop the chunk and stop recording
+            full = true;
+        }
+        else {
+            file.write(reinterpret_cast<const char*>(header.data()), header.size());
+            file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+            if (!file) throw std::runtime_error("Failed writing trajectory");
+
+            bytesWritten += size;
+            framesWritten += chunkFrames;
+        }
+
+        chunk.clear();
+        chunkFrames = 0;
+    }
+
+    uint64_t TrajectoryWriter::getFramesWritten() const { return framesWritten; }
+    uint64_t TrajectoryWriter::getBytesWritten() const { return bytesWritten; }
+    bool TrajectoryWriter::isFull() const { return full; }
+
+} // namespace Physics
@@ -1,9 +1,16 @@
 #include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
 
 #include "../headers/World.hpp"
 #include "../headers/Body.hpp"
 #include "../headers/Constants.hpp"
 #include "../headers/Property.hpp"
+#include "../headers/DirectSolver.hpp"
+#include "../headers/ThreadPool.hpp"
+#include "../headers/StepObserver.hpp"
+#include "../headers/SpatialHash.hpp"
 
 #include "../../Math/headers/Operation.hpp"
 #include "../../Math/headers/Vector.hpp"
@@ -11,59 +18,529 @@
 
 namespace Physics {
 
+    // Bodies integrated per task in the parallel sweep
+    static constexpr size_t IntegrationGrain = 4096;
+
+    // Yoshida's fourth order coefficients, w1 = 1 / (2 - 2^(1/3)) and w0 = -2^(1/3) w1
+    static const double YoshidaW1 = 1.0 / (2.0 - std::cbrt(2.0));
+    static const double YoshidaW0 = -std::cbrt(2.0) * YoshidaW1;
+
+    World::World() : solver(std::make_shared<DirectSolver>()), pool(std::make_unique<ThreadPool>()) {}
+
+    World::~World() {
+        // Hand the state back to the bodies so outstanding handles stay valid
+        for (size_t i = 0; i < bodies.size(); i++) {
+            bodies[i]->state = storage.load(i);
+            bodies[i]->world = nullptr;
+        }
+    }
+
     void World::addBody(std::shared_ptr<Body> body) {
+        if (body->world) {
+            throw std::runtime_error("Body already belongs to a World");
+        }
+
+        // Move the body's state into the world's storage
+        body->index = storage.size();
+        storage.push(body->state);
+        body->world = this;
+
         bodies.push_back(body);
+        accelerationsValid = false;
+    }
+
+    size_t World::addBodies(const BodyStorage& states) {
+        const size_t first = storage.size();
+        const size_t n = states.size();
+
+        auto append = [](std::vector<double>& to, const std::vector<double>& from) {
+            to.insert(to.end(), from.begin(), from.end());
+        };
+        reserve(first + n);
+        append(storage.x, states.x); append(storage.y, states.y);
+        append(storage.vx, states.vx); append(storage.vy, states.vy);
+        append(storage.fx, states.fx); append(storage.fy, states.fy);
+        append(storage.ax, states.ax); append(storage.ay, states.ay);
+        append(storage.mass, states.mass);
+        append(storage.invMass, states.invMass);
+        append(storage.radius, states.radius);
+
+        createHandles(first);
+        return first;
+    }
+
+    size_t World::addBodies(BodyStorage&& states) {
+        // An empty world takes the arrays over instead of copying them
+        if (storage.size() != 0) return addBodies(static_cast<const BodyStorage&>(states));
+
+        storage = std::move(states);
+        bodies.reserve(storage.size());
+        createHandles(0);
+        return 0;
+    }
+
+    void World::createHandles(size_t first) {
+        // The handles only need to know where their state lives
+        for (size_t i = first; i < storage.size(); i++) {
+            auto body = std::make_shared<Body>(storage.mass[i], Math::Vector(storage.x[i], storage.y[i]));
+            body->world = this;
+            body->index = i;
+            bodies.push_back(std::move(body));
+        }
+
+        accelerationsValid = false;
     }
 
     void World::removeBody(std::shared_ptr<Body> body) {
-        auto it = std::find(bodies.begin(), bodies.end(), body);
-        if (it != bodies.end()) {
-            bodies.erase(it);
+        if (body->world != this) return;
+
+        size_t index = body->index;
+
+        // Move the state back into the body
+        body->state = storage.load(index);
+        body->world = nullptr;
+
+        storage.erase(index);
+        bodies.erase(bodies.begin() + index);
+
+        // Bodies after the removed one shift down by one
+        for (size_t i = index; i < bodies.size(); i++) {
+            bodies[i]->index = i;
         }
+        accelerationsValid = false;
     }
 
     std::shared_ptr<Body> World::getBody(int index) {
-        if (index >= 0 && index < bodies.size()) {
+        if (index >= 0 && static_cast<size_t>(index) < bodies.size()) {
             return bodies[index];
         }
         throw std::out_of_range("Index out of range");
     }
 
+    void World::reserve(size_t n) {
+        storage.reserve(n);
+        bodies.reserve(n);
+    }
+
     size_t World::numBodies() const {
         return bodies.size();
     }
 
+    void World::setSolver(std::shared_ptr<GravitySolver> solver) {
+        if (!solver) {
+            throw std::invalid_argument("Solver cannot be null");
+        }
+        this->solver = solver;
+        accelerationsValid = false;
+    }
+
+    std::shared_ptr<GravitySolver> World::getSolver() const {
+        return solver;
+    }
+
+    void World::setThreadCount(size_t threads) {
+        pool = std::make_unique<ThreadPool>(threads);
+    }
+
+    size_t World::getThreadCount() const {
+        return pool->size();
+    }
+
+    ThreadPool& World::getThreadPool() {
+        return *pool;
+    }
+
+    void World::setIntegrator(Integrator integrator) {
+        this->integrator = integrator;
+    }
+
+    World::Integrator World::getIntegrator() const {
+        return integrator;
+    }
+
+    void World::setTimeStepAccuracy(double eta) {
+        if (!(eta > 0.0)) {
+            throw std::invalid_argument("Time step accuracy must be positive");
+        }
+        timeStepAccuracy = eta;
+    }
+
+    double World::getTimeStepAccuracy() const {
+        return timeStepAccuracy;
+    }
+
+    void World::setMaxTimeStepLevel(int level) {
+        if (level < 0 || level > 30) {
+            throw std::invalid_argument("Time step level must be between 0 and 30");
+        }
+        maxLevel = level;
+        levels.clear();
+    }
+
+    int World::getMaxTimeStepLevel() const {
+        return maxLevel;
+    }
+
+    const std::vector<uint8_t>& World::getTimeStepLevels() const {
+        return levels;
+    }
+
+    void World::setCollisionMode(CollisionMode mode) {
+        if (mode != CollisionMode::None && !broadPhase) broadPhase = std::make_unique<SpatialHash>();
+        collisionMode = mode;
+    }
+
+    World::CollisionMode World::getCollisionMode() const {
+        return collisionMode;
+    }
+
+    size_t World::getMergeCount() const {
+        return mergeCount;
+    }
+
+    void World::invalidateAccelerations() {
+        accelerationsValid = false;
+    }
+
+    double World::getTime() const {
+        return simulationTime;
+    }
+
+    void World::setTime(double time) {
+        simulationTime = time;
+    }
+
+    uint64_t World::getStepCount() const {
+        return stepCount;
+    }
+
+    void World::setStepCount(uint64_t steps) {
+        stepCount = steps;
+    }
+
+    void World::addObserver(std::shared_ptr<StepObserver> observer) {
+        if (!observer) {
+            throw std::invalid_argument("Observer cannot be null");
+        }
+        observers.push_back(observer);
+    }
+
+    void World::removeObserver(std::shared_ptr<StepObserver> observer) {
+        observers.erase(std::remove(observers.begin(), observers.end(), observer), observers.end());
+    }
+
+    const BodyStorage& World::getStorage() const {
+        return storage;
+    }
+
     void World::step(double time) {
-        calculateBodyAccelerations();
-        for (size_t i = 0; i < bodies.size(); i++) {
-            bodies[i]->step(time);
+        switch (integrator) {
+        case Integrator::SemiImplicitEuler:
+            calculateBodyAccelerations();
+            kick(time);
+            drift(time);
+            accelerationsValid = false;
+            break;
+
+        case Integrator::Leapfrog:
+            // The closing kick's accelerations open the next step
+            if (!accelerationsValid) calculateBodyAccelerations();
+            kick(0.5 * time);
+            drift(time);
+            calculateBodyAccelerations();
+            kick(0.5 * time);
+            accelerationsValid = true;
+            break;
+
+        case Integrator::Yoshida4:
+            // Three leapfrog steps of w1, w0, w1 with the adjacent half kicks merged
+            if (!accelerationsValid) calculateBodyAccelerations();
+            kick(0.5 * YoshidaW1 * time);
+            drift(YoshidaW1 * time);
+            calculateBodyAccelerations();
+            kick(0.5 * (YoshidaW1 + YoshidaW0) * time);
+            drift(YoshidaW0 * time);
+            calculateBodyAccelerations();
+            kick(0.5 * (YoshidaW0 + YoshidaW1) * time);
+            drift(YoshidaW1 * time);
+            calculateBodyAccelerations();
+            kick(0.5 * YoshidaW1 * time);
+            accelerationsValid = true;
+            break;
+
+        case Integrator::BlockLeapfrog:
+            stepBlocks(time);
+            break;
+        }
+
+        simulationTime += time;
+        stepCount++;
+
+        for (auto& observer : observers) {
+            observer->onStep(*this);
         }
     }
 
+    void World::stepBlocks(double time) {
+        const size_t n = storage.size();
+        if (n == 0) return;
+
+        if (!accelerationsValid || levels.size() != n) initializeLevels(time);
+
+        // Substeps are counted in ticks of the finest level, body i is due every ticks >> levels[i]
+        const uint64_t ticks = uint64_t(1) << maxLevel;
+        const double tick = time / ticks;
+
+        std::vector<double> half(maxLevel + 1);
+        std::vector<size_t> population(maxLevel + 1, 0);
+        for (int level = 0; level <= maxLevel; level++) half[level] = 0.5 * time / double(uint64_t(1) << level);
+        for (size_t i = 0; i < n; i++) population[levels[i]]++;
+
+        // Every body opens its step with the accelerations it ends the previous one with
+        active.resize(n);
+        for (size_t i = 0; i < n; i++) active[i] = static_cast<uint32_t>(i);
+        kickActive(half.data());
+        previousAx = storage.ax;
+        previousAy = storage.ay;
+
+        // Only ticks where the finest populated level is due have work, coarser levels are due on a subset
+        // of them. Jump straight from one to the next instead of visiting all 2^maxLevel ticks.
+        auto finestPopulated = [&]() {
+            int level = maxLevel;
+            while (level > 0 && population[level] == 0) level--;
+            return level;
+        };
+
+        uint64_t drifted = 0;
+        uint64_t stride = ticks >> finestPopulated();
+        for (uint64_t t = stride; t <= ticks; t = (t / stride + 1) * stride) {
+            // Everyone drifts, only the due bodies get new forces
+            drift((t - drifted) * tick);
+            drifted = t;
+
+            active.clear();
+            for (size_t i = 0; i < n; i++) {
+                if (t % (ticks >> levels[i]) == 0) active.push_back(static_cast<uint32_t>(i));
+            }
+
+            solver->computeActiveAccelerations(storage, active, *pool);
+            kickActive(half.data());
+
+            // New levels: refining is always allowed, coarsening one level at a time
+            // and only where the coarser step starts, so the block structure holds
+            for (uint32_t i : active) {
+                const double dt = 2.0 * half[levels[i]];
+                const double jx = (storage.ax[i] - previousAx[i]) / dt;
+                const double jy = (storage.ay[i] - previousAy[i]) / dt;
+                int wanted = chooseLevel(i, jx * jx + jy * jy, time);
+                int level = levels[i];
+
+                if (wanted > level) level = wanted;
+                else if (wanted < level && t % (ticks >> (level - 1)) == 0) level--;
+
+                population[levels[i]]--;
+                population[level]++;
+                levels[i] = static_cast<uint8_t>(level);
+                previousAx[i] = storage.ax[i];
+                previousAy[i] = storage.ay[i];
+            }
+
+            // Open the next step, the final one is opened by the next call
+            if (t < ticks) kickActive(half.data());
+
+            stride = ticks >> finestPopulated();
+        }
+
+        accelerationsValid = true;
+
+        // Every body is synchronised again, the next step starts over if any merged
+        if (collisionMode == CollisionMode::Merge) mergeCollisions();
+    }
+
+    void World::initializeLevels(double time) {
+        // Estimate the jerk by differencing accelerations over one finest substep
+        const double dt = time / double(uint64_t(1) << maxLevel);
+
+        // Collisions are resolved at the end of block steps, not in this probe
+        solver->computeAccelerations(storage, *pool);
+        std::vector<double> x = storage.x, y = storage.y;
+        previousAx = storage.ax;
+        previousAy = storage.ay;
+
+        drift(dt);
+        solver->computeAccelerations(storage, *pool);
+
+        levels.resize(storage.size());
+        for (size_t i = 0; i < storage.size(); i++) {
+            const double jx = (storage.ax[i] - previousAx[i]) / dt;
+            const double jy = (storage.ay[i] - previousAy[i]) / dt;
+            storage.ax[i] = previousAx[i];
+            storage.ay[i] = previousAy[i];
+            levels[i] = static_cast<uint8_t>(chooseLevel(i, jx * jx + jy * jy, time));
+        }
+
+        storage.x.swap(x);
+        storage.y.swap(y);
+        accelerationsValid = true;
+    }
+
+    int World::chooseLevel(size_t i, double jerk2, double time) const {
+        const double acceleration2 = storage.ax[i] * storage.ax[i] + storage.ay[i] * storage.ay[i];
+        if (jerk2 == 0.0) return 0;
+
+        // Coarsest level whose step is within eta * |a| / |da/dt|
+        const double limit = timeStepAccuracy * std::sqrt(acceleration2 / jerk2);
+        int level = 0;
+        while (level < maxLevel && time / double(uint64_t(1) << level) > limit) level++;
+        return level;
+    }
+
+    void World::kickActive(const double* time) {
+        double* vx = storage.vx.data();
+        double* vy = storage.vy.data();
+        const double* ax = storage.ax.data();
+        const double* ay = storage.ay.data();
+
+        pool->parallelFor(active.size(), IntegrationGrain, [&](size_t begin, size_t end, size_t) {
+            for (size_t k = begin; k < end; k++) {
+                const uint32_t i = active[k];
+                vx[i] += ax[i] * time[levels[i]];
+                vy[i] += ay[i] * time[levels[i]];
+            }
+        });
+    }
+
+    void World::kick(double time) {
+        double* vx = storage.vx.data();
+        double* vy = storage.vy.data();
+        const double* ax = storage.ax.data();
+        const double* ay = storage.ay.data();
+
+        pool->parallelFor(storage.size(), IntegrationGrain, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                vx[i] += ax[i] * time;
+                vy[i] += ay[i] * time;
+            }
+        });
+    }
+
+    void World::drift(double time) {
+        double* x = storage.x.data();
+        double* y = storage.y.data();
+        const double* vx = storage.vx.data();
+        const double* vy = storage.vy.data();
+
+        pool->parallelFor(storage.size(), IntegrationGrain, [&](size_t begin, size_t end, size_t) {
+            for (size_t i = begin; i < end; i++) {
+                x[i] += vx[i] * time;
+                y[i] += vy[i] * time;
+            }
+        });
+    }
+
     void World::calculateBodyAccelerations() {
-        for (size_t i = 0; i < bodies.size(); i++) {
-            bodies[i]->setKinematicProperty(KinematicProperty::Acceleration, Math::Vector::Zero);
+        // Bodies that touch at these positions merge first, so the forces already see the result
+        if (collisionMode == CollisionMode::Merge) mergeCollisions();
+        solver->computeAccelerations(storage, *pool);
+    }
 
-            Math::Vector position =
-                bodies[i]->getKinematicProperty(KinematicProperty::Position);
+    bool World::mergeCollisions() {
+        broadPhase->findPairs(storage, *pool, collisionPairs);
+        if (collisionPairs.empty()) return false;
 
-            for (size_t j = 0; j < bodies.size(); j++) {
-                if (i == j) continue;
+        const size_t n = storage.size();
+        mergeRoot.resize(n);
+        for (auto& [i, j] : collisionPairs) {
+            mergeRoot[i] = i;
+            mergeRoot[j] = j;
+        }
 
-                Math::Vector direction =
-                    bodies[j]->getKinematicProperty(KinematicProperty::Position) - position;
+        // Union-find over the touching pairs, every group is rooted at its lowest index
+        auto find = [&](uint32_t i) {
+            while (mergeRoot[i] != i) {
+                mergeRoot[i] = mergeRoot[mergeRoot[i]];
+                i = mergeRoot[i];
+            }
+            return i;
+        };
+        for (auto& [i, j] : collisionPairs) {
+            uint32_t a = find(i), b = find(j);
+            if (a < b) mergeRoot[b] = a;
+            else if (b < a) mergeRoot[a] = b;
+        }
 
-                double distance = Math::Operation::Length(direction);
-                direction = direction / distance;
+        // Fold every absorbed body into its root. Positions and velocities are summed weighted
+        // by mass and divided at the end, volumes add up. A group without mass has no centre
+        // of mass, its bodies are weighted equally instead.
+        std::vector<uint32_t> members;
+        members.reserve(2 * collisionPairs.size());
+        for (auto& [i, j] : collisionPairs) {
+            members.push_back(i);
+            members.push_back(j);
+        }
+        std::sort(members.begin(), members.end());
+        members.erase(std::unique(members.begin(), members.end()), members.end());
+
+        std::vector<double> groupMass(n, 0.0), groupWeight(n, 0.0);
+        for (uint32_t i : members) groupMass[find(i)] += storage.mass[i];
+
+        absorbed.assign(n, 0);
+        for (uint32_t i : members) {
+            const uint32_t root = find(i);
+            const double m = storage.mass[i];
+            const double w = groupMass[root] != 0.0 ? m : 1.0;
+            groupWeight[root] += w;
+            if (root == i) {
+                storage.x[i] *= w; storage.y[i] *= w;
+                storage.vx[i] *= w; storage.vy[i] *= w;
+                storage.ax[i] *= w; storage.ay[i] *= w;
+                storage.radius[i] = storage.radius[i] * storage.radius[i] * storage.radius[i];
+                continue;
+            }
 
-                double mass = bodies[j]->getPhysicalProperty(PhysicalProperty::Mass);
+            // Roots have lower indices, so they are set up before their members arrive
+            absorbed[i] = 1;
+            storage.mass[root] += m;
+            storage.x[root] += w * storage.x[i]; storage.y[root] += w * storage.y[i];
+            storage.vx[root] += w * storage.vx[i]; storage.vy[root] += w * storage.vy[i];
+            storage.fx[root] += storage.fx[i]; storage.fy[root] += storage.fy[i];
+            storage.ax[root] += w * storage.ax[i]; storage.ay[root] += w * storage.ay[i];
+            storage.radius[root] += storage.radius[i] * storage.radius[i] * storage.radius[i];
+        }
 
-                double accelerationMagnitude = Constants::GRAVITATIONAL_CONSTANT * mass / (distance * distance);
-                Math::Vector acceleration = direction * accelerationMagnitude;
+        size_t merged = 0;
+        for (uint32_t i : members) {
+            if (absorbed[i]) {
+                merged++;
+                continue;
+            }
+            const double w = groupWeight[i];
+            storage.invMass[i] = 1.0 / storage.mass[i];
+            storage.x[i] /= w; storage.y[i] /= w;
+            storage.vx[i] /= w; storage.vy[i] /= w;
+            storage.ax[i] /= w; storage.ay[i] /= w;
+            storage.radius[i] = std::cbrt(storage.radius[i]);
+        }
 
-                bodies[i]->addKinematicProperty(KinematicProperty::Acceleration, acceleration);
+        // Absorbed handles keep their last state, the survivors move down in one pass
+        size_t kept = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (absorbed[i]) {
+                bodies[i]->state = storage.load(i);
+                bodies[i]->world = nullptr;
+                continue;
             }
+            bodies[i]->index = kept;
+            if (kept != i) bodies[kept] = std::move(bodies[i]);
+            kept++;
         }
+        bodies.resize(kept);
+        storage.compact(absorbed);
+
+        mergeCount += merged;
+        levels.clear();
+        accelerationsValid = false;
+        return true;
     }
 
-} // namespace Physics
\ No newline at end of file
+} // namespace Physics
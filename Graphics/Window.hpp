@@ -2,6 +2,9 @@
 #define WINDOW_HPP
 
 #include <iostream>
+#include <vector>
+#include <cmath>
+#include <algorithm>
 #include <SFML/Graphics.hpp>
 #include "Shapes.hpp"
 #include "Color.hpp"
@@ -26,6 +29,76 @@ namespace Graphics {
         Graphics::Color bgColor;       ///< Background color of the window
         float zoomLevel;               ///< Current zoom level of the camera
         float lastFrameTime = 0.0f;    ///< Time of the last frame, used for frame time calculation
+        sf::FloatRect viewBounds;      ///< Region of the world the camera shows, with positive width and height
+
+        sf::VertexArray lineBatch{ sf::Lines };  ///< Batched line segments, drawn by flushBatch()
+        sf::VertexArray discBatch{ sf::Quads };  ///< Batched discs, one textured quad each, drawn by flushBatch()
+        sf::Texture discTexture;                 ///< White antialiased disc, tinted by the vertex colors of discBatch
+        bool discTextureReady = false;           ///< Whether discTexture has been generated
+
+        static constexpr unsigned discTextureSize = 64; ///< Side of discTexture in pixels
+
+        sf::VertexArray gridLines{ sf::Lines };  ///< Cached grid, rebuilt by drawGridLines() when its inputs change
+        sf::FloatRect gridBounds;                ///< View the grid was built for
+        float gridBaseSize = 0.0f;               ///< Base spacing the grid was built with
+        float gridMinPixelSpacing = 0.0f;        ///< Minimum pixel spacing the grid was built with
+        Graphics::Color gridColor;               ///< Color the grid was built with
+
+        /**
+         * @brief Recomputes viewBounds from the camera. Called whenever the camera changes.
+         */
+        void updateViewBounds() {
+            float left, right, top, bottom;
+            getCameraExtent(left, right, top, bottom);
+            viewBounds = sf::FloatRect(std::min(left, right), std::min(top, bottom), std::abs(right - left), std::abs(bottom - top));
+        }
+
+        /**
+         * @brief Fills gridLines with the grid over gridBounds, lines aligned on the origin.
+         */
+        void buildGridLines() {
+            gridLines.clear();
+            if (!(gridBaseSize > 0.0f)) return;
+
+            // 1, 2, 5, 10, 20, 50... times the base size, until lines are far enough apart on screen
+            const float minSpacing = gridMinPixelSpacing * getPixelSize();
+            float spacing = gridBaseSize;
+            for (int i = 0; spacing < minSpacing; i++) spacing *= (i % 3 == 1) ? 2.5f : 2.0f;
+
+            const float left = gridBounds.left, right = gridBounds.left + gridBounds.width;
+            const float top = gridBounds.top, bottom = gridBounds.top + gridBounds.height;
+            const sf::Color sfColor = gridColor.toSFML();
+
+            for (float k = std::ceil(left / spacing); k * spacing <= right; k++) {
+                gridLines.append(sf::Vertex(sf::Vector2f(k * spacing, top), sfColor));
+                gridLines.append(sf::Vertex(sf::Vector2f(k * spacing, bottom), sfColor));
+            }
+            for (float k = std::ceil(top / spacing); k * spacing <= bottom; k++) {
+                gridLines.append(sf::Vertex(sf::Vector2f(left, k * spacing), sfColor));
+                gridLines.append(sf::Vertex(sf::Vector2f(right, k * spacing), sfColor));
+            }
+        }
+
+        /**
+         * @brief Generates the disc texture used by the batched circles: white, with an alpha edge one pixel wide.
+         */
+        void createDiscTexture() {
+            sf::Image image;
+            image.create(discTextureSize, discTextureSize, sf::Color::Transparent);
+
+            const float center = discTextureSize / 2.0f;
+            for (unsigned y = 0; y < discTextureSize; y++) {
+                for (unsigned x = 0; x < discTextureSize; x++) {
+                    float distance = std::hypot(x + 0.5f - center, y + 0.5f - center);
+                    float coverage = std::clamp(center - distance, 0.0f, 1.0f);
+                    image.setPixel(x, y, sf::Color(255, 255, 255, static_cast<sf::Uint8>(coverage * 255.0f)));
+                }
+            }
+
+            discTexture.loadFromImage(image);
+            discTexture.setSmooth(true);
+            discTextureReady = true;
+        }
 
     public:
         friend class Mouse; // Allow Mouse class to access private members of Window
@@ -64,6 +137,7 @@ namespace Graphics {
 
             // Apply the zoom level to the camera
             camera.zoom(zoomLevel);
+            updateViewBounds();
 
             std::cout << "Zoom Level: " << zoomLevel << std::endl;
 
@@ -136,9 +210,10 @@ namespace Graphics {
         }
 
         /**
-         * @brief Displays the current contents of the window.
+         * @brief Displays the current contents of the window, drawing whatever is still batched first.
          */
         void display() {
+            flushBatch();
             window.display();
         }
 
@@ -247,28 +322,120 @@ namespace Graphics {
         }
 
         /**
-         * @brief Draws a grid with lines at regular intervals.
-         * @param gridSize The distance between two consecutive grid lines (default is 1.0f).
-         * @param color The color of the grid lines (default is Graphics::Color::White).
+         * @brief Checks whether a point, or a disc around it, is inside the camera's view.
+         * @param point The point to check.
+         * @param margin The radius of the disc around the point (default is 0).
+         * @return True if the point is within margin of the view.
          */
-        void drawGridLines(float gridSize = 1.0f, Graphics::Color color = Graphics::Color::White) {
-            float left, right, top, bottom;
-            getCameraExtent(left, right, top, bottom);
+        bool isInView(const sf::Vector2f& point, float margin = 0.0f) const {
+            return point.x + margin >= viewBounds.left && point.x - margin <= viewBounds.left + viewBounds.width &&
+                point.y + margin >= viewBounds.top && point.y - margin <= viewBounds.top + viewBounds.height;
+        }
 
-            for (float x = 0; x <= right; x += gridSize) {
-                drawLine(sf::Vector2f(x, top), sf::Vector2f(x, bottom), color);
-                if (x != 0) {
-                    drawLine(sf::Vector2f(-x, top), sf::Vector2f(-x, bottom), color);
-                }
+        /**
+         * @brief Checks whether the bounding box of a segment meets the camera's view.
+         * @paragraph Conservative: a segment passing just by a corner of the view is kept.
+         * @param point1 The start point of the segment.
+         * @param point2 The end point of the segment.
+         * @return False only if the segment is certainly outside the view.
+         */
+        bool isInView(const sf::Vector2f& point1, const sf::Vector2f& point2) const {
+            return std::max(point1.x, point2.x) >= viewBounds.left && std::min(point1.x, point2.x) <= viewBounds.left + viewBounds.width &&
+                std::max(point1.y, point2.y) >= viewBounds.top && std::min(point1.y, point2.y) <= viewBounds.top + viewBounds.height;
+        }
+
+        /**
+         * @brief Queues a filled circle for the next flushBatch().
+         * @paragraph Unlike drawCircleFilled, no shape is built: the circle becomes four vertices of a textured quad,
+         * so thousands of bodies cost a single draw call. Circles outside the camera's view are dropped.
+         * @param radius The radius of the circle.
+         * @param position The position of the circle.
+         * @param color The fill color of the circle.
+         */
+        void batchCircle(float radius, const sf::Vector2f& position, Graphics::Color color) {
+            if (!isInView(position, radius)) return;
+
+            const sf::Color tint = color.toSFML();
+            const float size = static_cast<float>(discTextureSize);
+
+            discBatch.append(sf::Vertex(sf::Vector2f(position.x - radius, position.y - radius), tint, sf::Vector2f(0.0f, 0.0f)));
+            discBatch.append(sf::Vertex(sf::Vector2f(position.x + radius, position.y - radius), tint, sf::Vector2f(size, 0.0f)));
+            discBatch.append(sf::Vertex(sf::Vector2f(position.x + radius, position.y + radius), tint, sf::Vector2f(size, size)));
+            discBatch.append(sf::Vertex(sf::Vector2f(position.x - radius, position.y + radius), tint, sf::Vector2f(0.0f, size)));
+        }
+
+        /**
+         * @brief Queues a line between two points for the next flushBatch(), unless it is outside the camera's view.
+         * @param point1 The start point of the line.
+         * @param point2 The end point of the line.
+         * @param color The color of the line (default is white).
+         */
+        void batchLine(const sf::Vector2f& point1, const sf::Vector2f& point2, Graphics::Color color = Graphics::Color::White) {
+            if (!isInView(point1, point2)) return;
+
+            const sf::Color sfColor = color.toSFML();
+            lineBatch.append(sf::Vertex(point1, sfColor));
+            lineBatch.append(sf::Vertex(point2, sfColor));
+        }
+
+        /**
+         * @brief Queues a polyline through the given points for the next flushBatch().
+         * @paragraph Strips are stored as separate segments, so any number of them share one draw call,
+         * and segments outside the camera's view are dropped.
+         * @param points The points of the polyline, in order.
+         * @param color The color of the polyline (default is white).
+         */
+        void batchLineStrip(const std::vector<sf::Vector2f>& points, Graphics::Color color = Graphics::Color::White) {
+            const sf::Color sfColor = color.toSFML();
+            for (size_t i = 0; i + 1 < points.size(); i++) {
+                if (!isInView(points[i], points[i + 1])) continue;
+                lineBatch.append(sf::Vertex(points[i], sfColor));
+                lineBatch.append(sf::Vertex(points[i + 1], sfColor));
             }
+        }
 
-            for (float y = 0; y <= top; y += gridSize) {
-                drawLine(sf::Vector2f(left, y), sf::Vector2f(right, y), color);
-                if (y != 0) {
-                    drawLine(sf::Vector2f(left, -y), sf::Vector2f(right, -y), color);
-                }
+        /**
+         * @brief Draws everything queued by the batch functions, lines first and circles over them, then empties the batches.
+         * @paragraph The vertex arrays keep their memory, so after the first frames batching does not allocate.
+         */
+        void flushBatch() {
+            if (lineBatch.getVertexCount() > 0) {
+                window.draw(lineBatch);
+                lineBatch.clear();
             }
 
+            if (discBatch.getVertexCount() > 0) {
+                if (!discTextureReady) createDiscTexture();
+                window.draw(discBatch, sf::RenderStates(&discTexture));
+                discBatch.clear();
+            }
+        }
+
+        /**
+         * @brief Draws a grid with lines at regular intervals.
+         * @paragraph The lines are built once into a vertex array and drawn in one call. They are rebuilt only when the
+         * camera's view or the arguments change. The spacing adapts to the zoom level: gridSize is multiplied by 2, 5, 10,
+         * 20, 50... until lines are at least minPixelSpacing pixels apart, so the number of lines stays bounded.
+         * @param gridSize The smallest distance between two consecutive grid lines (default is 1.0f).
+         * @param color The color of the grid lines (default is Graphics::Color::White).
+         * @param minPixelSpacing The smallest distance between two lines on screen, in pixels (default is 32).
+         */
+        void drawGridLines(float gridSize = 1.0f, Graphics::Color color = Graphics::Color::White, float minPixelSpacing = 32.0f) {
+            const bool stale = gridLines.getVertexCount() == 0 ||
+                viewBounds.left != gridBounds.left || viewBounds.top != gridBounds.top ||
+                viewBounds.width != gridBounds.width || viewBounds.height != gridBounds.height ||
+                gridSize != gridBaseSize || minPixelSpacing != gridMinPixelSpacing ||
+                color.r != gridColor.r || color.g != gridColor.g || color.b != gridColor.b || color.a != gridColor.a;
+
+            if (stale) {
+                gridBounds = viewBounds;
+                gridBaseSize = gridSize;
+                gridMinPixelSpacing = minPixelSpacing;
+                gridColor = color;
+                buildGridLines();
+            }
+
+            window.draw(gridLines);
             drawCircleFilled(0.1f, sf::Vector2f(0.0f, 0.0f), Graphics::Color::Red);
         }
 
@@ -297,6 +464,23 @@ namespace Graphics {
             zoomLevel *= factor;
             camera.zoom(factor);
             window.setView(camera);
+            updateViewBounds();
+        }
+
+        /**
+         * @brief Gets the current zoom level of the camera.
+         * @return The zoom level, larger when zoomed out.
+         */
+        float getZoomLevel() const {
+            return zoomLevel;
+        }
+
+        /**
+         * @brief Gets the size of one screen pixel in world units at the current zoom level.
+         * @return The world distance one pixel covers.
+         */
+        float getPixelSize() const {
+            return zoomLevel / pixelPerMeter;
         }
 
         /**
@@ -0,0 +1,311 @@
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "Engine/Physics/core.hpp"
+#include "Utils/StopWatch.hpp"
+
+// Runs a scenario without a window, as fast as the machine allows.
+// Only Engine/Physics and Engine/Math are needed to build it.
+
+struct RunOptions {
+    std::string scenario;           ///< Scenario CSV to load
+    std::string generate;           ///< Generated initial conditions instead of a scenario
+    size_t bodies = 10000;          ///< Bodies to generate
+    uint64_t seed = 1;              ///< Seed of the generated initial conditions
+    double radius = 0.0;            ///< Collision radius of generated disk, ring and box bodies
+    long long steps = -1;           ///< Number of steps, -1 when running until endTime
+    double endTime = -1.0;          ///< Simulated end time in seconds, -1 when running a step count
+    double timeStep = 3600.0;       ///< Step size in seconds
+    std::string solver = "direct";
+    std::string precision = "double";   ///< Pairwise math of the direct solver
+    std::string integrator;         ///< Empty for leapfrog, or the checkpoint's integrator when resuming
+    std::string collisions = "none";
+    size_t threads = 0;             ///< 0 uses every hardware thread
+    std::string output;             ///< Final state, in scenario format
+    std::string trajectory;         ///< Body states every trajectoryEvery steps
+    long long trajectoryEvery = 100;
+    long long reportEvery = 0;      ///< Progress line every n steps, 0 for none
+    std::string checkpoint;         ///< Binary checkpoint written periodically and at the end
+    long long checkpointEvery = 1000;
+    bool resume = false;            ///< Start from the checkpoint when it exists
+};
+
+static void printUsage() {
+    std::cout <<
+        "Usage: HeadlessRunner <scenario.csv> [options]\n"
+        "       HeadlessRunner --generate KIND [--bodies N] [--seed S] [options]\n"
+        "  --generate KIND      Generate plummer, disk, ring or box initial conditions\n"
+        "  --bodies N           Bodies to generate (default 10000)\n"
+        "  --seed S             Seed of the generated bodies (default 1)\n"
+        "  --radius R           Collision radius of generated disk, ring and box bodies in meters\n"
+        "  --steps N            Number of steps to run, counted from t = 0 when resuming\n"
+        "  --until T            Run until the simulated time reaches T seconds\n"
+        "  --dt S               Step size in seconds (default 3600)\n"
+        "  --solver NAME        direct, barnes-hut, fmm or pm (default direct)\n"
+        "  --precision P        double or mixed, float pairwise math in the direct solver (default double)\n"
+        "  --integrator NAME    euler, leapfrog, yoshida or block (default leapfrog, or the checkpoint's)\n"
+        "  --collisions MODE    none or merge, bodies with a radius merge on contact (default none)\n"
+        "  --threads N          Worker threads, 0 for all (default 0)\n"
+        "  --output FILE        Write the final state as a scenario CSV\n"
+        "  --trajectory FILE    Write body states every --every steps, compressed binary\n"
+        "                       for .traj files (see Physics::TrajectoryReader), CSV otherwise\n"
+        "  --every N            Trajectory interval in steps (default 100)\n"
+        "  --report N           Print progress every N steps\n"
+        "  --checkpoint FILE    Write a binary checkpoint every --checkpoint-every steps and at the end\n"
+        "  --checkpoint-every N Checkpoint interval in steps (default 1000)\n"
+        "  --resume             Continue from the checkpoint file if it exists\n";
+}
+
+static RunOptions parseOptions(int argc, char** argv) {
+    RunOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+            return argv[++i];
+        };
+
+        if (arg == "--steps") options.steps = std::stoll(value());
+        else if (arg == "--generate") options.generate = value();
+        else if (arg == "--bodies") options.bodies = std::stoul(value());
+        else if (arg == "--seed") options.seed = std::stoull(value());
+        else if (arg == "--radius") options.radius = std::stod(value());
+        else if (arg == "--until") options.endTime = std::stod(value());
+        else if (arg == "--dt") options.timeStep = std::stod(value());
+        else if (arg == "--solver") options.solver = value();
+        else if (arg == "--precision") options.precision = value();
+        else if (arg == "--integrator") options.integrator = value();
+        else if (arg == "--collisions") options.collisions = value();
+        else if (arg == "--threads") options.threads = std::stoul(value());
+        else if (arg == "--output") options.output = value();
+        else if (arg == "--trajectory") options.trajectory = value();
+        else if (arg == "--every") options.trajectoryEvery = std::stoll(value());
+        else if (arg == "--report") options.reportEvery = std::stoll(value());
+        else if (arg == "--checkpoint") options.checkpoint = value();
+        else if (arg == "--checkpoint-every") options.checkpointEvery = std::stoll(value());
+        else if (arg == "--resume") options.resume = true;
+        else if (!arg.empty() && arg[0] == '-') throw std::invalid_argument("Unknown option " + arg);
+        else if (options.scenario.empty()) options.scenario = arg;
+        else throw std::invalid_argument("Unexpected argument " + arg);
+    }
+
+    if (options.scenario.empty() == options.generate.empty()) throw std::invalid_argument("Give either a scenario or --generate");
+    if ((options.steps < 0) == (options.endTime < 0.0)) throw std::invalid_argument("Give exactly one of --steps or --until");
+    if (!(options.timeStep > 0.0)) throw std::invalid_argument("--dt must be positive");
+    if (options.trajectoryEvery <= 0) throw std::invalid_argument("--every must be positive");
+    if (options.checkpointEvery <= 0) throw std::invalid_argument("--checkpoint-every must be positive");
+    if (options.resume && options.checkpoint.empty()) throw std::invalid_argument("--resume needs --checkpoint");
+    return options;
+}
+
+static std::shared_ptr<Physics::GravitySolver> makeSolver(const std::string& name, const std::string& precision) {
+    if (precision != "double" && precision != "mixed") throw std::invalid_argument("Unknown precision " + precision);
+    if (precision == "mixed" && name != "direct") throw std::invalid_argument("--precision mixed needs the direct solver");
+
+    if (name == "direct") {
+        auto direct = std::make_shared<Physics::DirectSolver>();
+        if (precision == "mixed") direct->setPrecision(Physics::DirectSolver::Precision::Mixed);
+        return direct;
+    }
+    if (name == "barnes-hut") return std::make_shared<Physics::BarnesHutSolver>();
+    if (name == "fmm") return std::make_shared<Physics::FastMultipoleSolver>();
+    if (name == "pm") return std::make_shared<Physics::ParticleMeshSolver>();
+    throw std::invalid_argument("Unknown solver " + name);
+}
+
+static Physics::World::Integrator makeIntegrator(const std::string& name) {
+    if (name == "euler") return Physics::World::Integrator::SemiImplicitEuler;
+    if (name == "leapfrog") return Physics::World::Integrator::Leapfrog;
+    if (name == "yoshida") return Physics::World::Integrator::Yoshida4;
+    if (name == "block") return Physics::World::Integrator::BlockLeapfrog;
+    throw std::invalid_argument("Unknown integrator " + name);
+}
+
+// Generators use their default scales, see Physics::Generators
+static size_t generateBodies(const RunOptions& options, Physics::World& world) {
+    using Physics::Generators;
+
+    if (options.generate == "plummer") {
+        Generators::PlummerOptions plummer;
+        plummer.count = options.bodies;
+        return Generators::plummer(world, plummer, options.seed);
+    }
+    if (options.generate == "disk") {
+        Generators::DiskOptions disk;
+        disk.count = options.bodies;
+        disk.radius = options.radius;
+        return Generators::disk(world, disk, options.seed);
+    }
+    if (options.generate == "ring") {
+        Generators::RingOptions ring;
+        ring.count = options.bodies > 0 ? options.bodies - 1 : 0; // The central body counts too
+        ring.radius = options.radius;
+        return Generators::ring(world, ring, options.seed);
+    }
+    if (options.generate == "box") {
+        Generators::BoxOptions box;
+        box.count = options.bodies;
+        box.radius = options.radius;
+        return Generators::box(world, box, options.seed);
+    }
+    throw std::invalid_argument("Unknown generator " + options.generate);
+}
+
+static Physics::World::CollisionMode makeCollisionMode(const std::string& name) {
+    if (name == "none") return Physics::World::CollisionMode::None;
+    if (name == "merge") return Physics::World::CollisionMode::Merge;
+    throw std::invalid_argument("Unknown collision mode " + name);
+}
+
+static void writeTrajectory(std::ofstream& file, long long step, const Physics::World& world) {
+    const Physics::BodyStorage& storage = world.getStorage();
+    for (size_t i = 0; i < storage.size(); i++) {
+        file << step << ',' << world.getTime() << ',' << i << ','
+            << storage.x[i] << ',' << storage.y[i] << ','
+            << storage.vx[i] << ',' << storage.vy[i] << '\n';
+    }
+}
+
+static void run(const RunOptions& options) {
+    Physics::World world;
+    world.setThreadCount(options.threads);
+    world.setSolver(makeSolver(options.solver, options.precision));
+
+    size_t bodies;
+    bool resumed = false;
+    long long firstStep = 0;
+    if (options.resume && std::filesystem::exists(options.checkpoint)) {
+        Physics::Checkpoint checkpoint(options.checkpoint);
+        checkpoint.restore(world);
+        bodies = checkpoint.size();
+        resumed = true;
+        // Version 1 files have no step count, estimate it from the time
+        if (!checkpoint.hasStepCount()) world.setStepCount(static_cast<uint64_t>(std::llround(world.getTime() / options.timeStep)));
+        firstStep = static_cast<long long>(world.getStepCount());
+        std::cout << "Resumed " << bodies << " bodies at t = " << world.getTime() << " s from " << options.checkpoint;
+    }
+    else if (!options.generate.empty()) {
+        bodies = generateBodies(options, world);
+        std::cout << "Generated " << bodies << " bodies (" << options.generate << ", seed " << options.seed << ")";
+    }
+    else {
+        bodies = Physics::Scenario::load(options.scenario, world);
+        std::cout << "Loaded " << bodies << " bodies from " << options.scenario;
+    }
+    std::cout << ", " << world.getThreadCount() << " threads\n";
+
+    // A resumed run keeps the checkpoint's integrator unless one is asked for
+    if (!options.integrator.empty()) world.setIntegrator(makeIntegrator(options.integrator));
+    else if (!resumed) world.setIntegrator(makeIntegrator("leapfrog"));
+    world.setCollisionMode(makeCollisionMode(options.collisions));
+
+    std::shared_ptr<Physics::AutoCheckpoint> autoCheckpoint;
+    if (!options.checkpoint.empty()) {
+        autoCheckpoint = std::make_shared<Physics::AutoCheckpoint>(options.checkpoint, options.checkpointEvery);
+        world.addObserver(autoCheckpoint);
+    }
+
+    std::ofstream trajectory;
+    std::shared_ptr<Physics::TrajectoryWriter> trajectoryWriter;
+    if (std::filesystem::path(options.trajectory).extension() == ".traj") {
+        Physics::TrajectoryWriter::Options trajectoryOptions;
+        trajectoryOptions.decimation = static_cast<size_t>(options.trajectoryEvery);
+        trajectoryWriter = std::make_shared<Physics::TrajectoryWriter>(options.trajectory, trajectoryOptions);
+        trajectoryWriter->record(world);
+        world.addObserver(trajectoryWriter);
+    }
+    else if (!options.trajectory.empty()) {
+        trajectory.open(options.trajectory);
+        if (!trajectory.is_open()) throw std::runtime_error("Unable to write " + options.trajectory);
+        trajectory.precision(17);
+        trajectory << "step,time,body,x,y,vx,vy\n";
+        writeTrajectory(trajectory, 0, world);
+    }
+
+    Utils::Stopwatch stopwatch;
+    stopwatch.start();
+
+    // --steps is a total, so a resumed run picks up the count where the checkpoint left it
+    long long step = firstStep;
+    bool landed = false;            // The last step ended on --until
+    auto finished = [&]() {
+        if (options.steps >= 0) return step >= options.steps;
+        return landed || world.getTime() >= options.endTime;
+    };
+
+    while (!finished()) {
+        // Land exactly on the end time. time + dt can round just below it, so the landing
+        // step ends the run and the clock is set to the end time rather than summed.
+        double dt = options.timeStep;
+        if (options.endTime >= 0.0 && world.getTime() + dt >= options.endTime) {
+            dt = options.endTime - world.getTime();
+            landed = true;
+        }
+
+        world.step(dt);
+        if (landed) world.setTime(options.endTime);
+        step++;
+
+        if (trajectory.is_open() && step % options.trajectoryEvery == 0) writeTrajectory(trajectory, step, world);
+
+        if (options.reportEvery > 0 && step % options.reportEvery == 0) {
+            double elapsed = stopwatch.getElapsedTimeInSeconds();
+            std::cout << "step " << step << ", t = " << world.getTime() << " s, "
+                << (step - firstStep) / elapsed << " steps/s\n";
+        }
+    }
+
+    stopwatch.stop();
+    double elapsed = stopwatch.getElapsedTimeInSeconds();
+
+    const long long taken = step - firstStep;
+    std::cout << taken << " steps to t = " << world.getTime() << " s in " << elapsed << " s: "
+        << taken / elapsed << " steps/s, " << taken * double(bodies) / elapsed << " body-steps/s\n";
+
+    if (world.getCollisionMode() != Physics::World::CollisionMode::None) {
+        std::cout << world.getMergeCount() << " bodies merged, " << world.numBodies() << " left\n";
+    }
+
+    if (trajectoryWriter) {
+        trajectoryWriter->close();
+        std::cout << trajectoryWriter->getFramesWritten() << " trajectory frames, "
+            << trajectoryWriter->getBytesWritten() << " bytes written to " << options.trajectory << "\n";
+    }
+
+    if (autoCheckpoint) {
+        autoCheckpoint->flush();
+        Physics::Checkpoint::save(world, options.checkpoint);
+        std::cout << "Checkpoint written to " << options.checkpoint << "\n";
+    }
+
+    if (!options.output.empty()) {
+        Physics::Scenario::save(options.output, world);
+        std::cout << "Final state written to " << options.output << "\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    try {
+        run(parseOptions(argc, argv));
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
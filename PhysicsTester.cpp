@@ -1,64 +1,36 @@
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <stdexcept>
 #include <vector>
 
 #include "Utils/Simulation.hpp"
 #include "Utils/Random.hpp"
+#include "Utils/Trail.hpp"
 
 class PlanetSystem : public Utils::Simulation {
-    Physics::World world; ///< Physics world to simulate physical interactions
     std::vector<Graphics::Color> colors; ///< Colors assigned to celestial bodies
-    std::vector<Physics::Path> orbits; ///< Stores the paths (orbits) of celestial bodies
+    std::vector<Utils::Trail> orbits; ///< Stores the paths (orbits) of celestial bodies
 
 private:
     void DrawOrbits() {
         if (orbits.size() < 2) return; // Skip if there are fewer than 2 orbits
-        for (int i = 0; i < orbits.size(); i++) {
-            for (int j = 0; j < orbits[i].getSize() - 1; j++) {
-                window.drawLine(
-                    Math::Converter::toVector2f(orbits[i].get(j)),
-                    Math::Converter::toVector2f(orbits[i].get(j + 1)),
-                    colors[i].withAlha(80) // Use a semi-transparent color for the orbit
-                );
-            }
+        for (size_t i = 0; i < orbits.size(); i++) {
+            orbits[i].draw(window, colors[i].withAlha(80)); // Use a semi-transparent color for the orbit
         }
     }
 
     void loadBodiesFromCSV(const std::string& filename) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
-            std::cerr << "Error: Unable to open file " << filename << std::endl;
+        try {
+            Physics::Scenario::load(filename, world); // Parse the file and add its bodies to the world
+        }
+        catch (const std::runtime_error& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
             return;
         }
 
-        std::string line;
-        std::getline(file, line); // Skip the header line
-
-        // Read each line to extract body properties
-        while (std::getline(file, line)) {
-            std::stringstream ss(line);
-            double mass, distanceX, distanceY, velocityX, velocityY;
-            char comma;
-
-            // Parse mass, distance, and velocity from the CSV
-            ss >> mass >> comma >> distanceX >> comma >> distanceY >> comma >> velocityX >> comma >> velocityY;
-
-            Math::Vector position(distanceX, distanceY); // Position vector
-            Math::Vector velocity(velocityX, velocityY); // Velocity vector
-
-            // Create a new body with the parsed mass and position
-            std::shared_ptr<Physics::Body> body = std::make_shared<Physics::Body>(mass, position);
-
-            // Set velocity
-            body->setKinematicProperty(Physics::KinematicProperty::LinearVelocity, velocity);
-            world.addBody(body); // Add the body to the physics world
-
-            colors.push_back(Utils::Random::Color()); // Assign a random color to the body
-        }
+        // Assign a random color to each body
+        for (size_t i = 0; i < world.numBodies(); i++) colors.push_back(Utils::Random::Color());
 
         orbits.resize(world.numBodies()); // Resize the orbits vector to match the number of bodies
-        file.close(); // Close the CSV file
     }
 
     double get_max_distance() override {
@@ -78,24 +50,23 @@ private:
 public:
     PlanetSystem(std::string filename) : Utils::Simulation("Solar System Simulation") {
         loadBodiesFromCSV(filename); // Load celestial bodies from CSV file
+        world.setIntegrator(Physics::World::Integrator::Yoshida4); // Stable orbits at large time steps
+        setTimeStep(3600.0); // One hour steps, the speed sets how many are taken per second
         init();
-    }
 
-    void step() override {
-        world.step(window.getElapsedTimeSinceLastFrame(Graphics::TimeUnit::Seconds) * speedFactor);
+        // Take a trail point once a body has moved 0.02 screen units, about a fifth of a drawn body radius
+        for (auto& orbit : orbits) orbit.getPath().setMinDistance(0.02 * Math::Converter::getScale());
     }
 
     void draw_bodies() override {
-        for (int i = 0; i < world.numBodies(); i++) {
-            std::shared_ptr<Physics::Body> body = world.getBody(i); // Get the body object
-
-            // Get the position of the body
-            const Math::Vector& pos = body->getKinematicProperty(Physics::KinematicProperty::Position);
+        const Snapshot& snapshot = getSnapshot();
+        for (size_t i = 0; i < snapshot.positions.size() && i < orbits.size(); i++) {
+            const Math::Vector& pos = snapshot.positions[i];
 
             orbits[i].insert(pos); // Add the position to the orbit path
 
-            // Draw the body as a tiny circle with a border
-            window.drawCircleWithBorder(0.01f, Math::Converter::toVector2f(pos), colors[i], 0.1f, colors[i]);
+            // Draw the body as a small filled circle, the size of the old bordered one. Bodies out of view are culled.
+            window.batchCircle(0.11f, Math::Converter::toVector2f(pos), colors[i]);
         }
         DrawOrbits(); // Draw orbital paths
     }
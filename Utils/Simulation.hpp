@@ -2,6 +2,13 @@
 #define SIMULATION_HPP
 
 #include <memory>     // For std::shared_ptr
+#include <algorithm>  // For std::min
+#include <stdexcept>  // For std::invalid_argument
+#include <atomic>     // For the physics thread's stop flag
+#include <chrono>     // For timing the physics loop
+#include <thread>     // For the physics thread
+#include <vector>
+#include <cstdint>
 
 // Include Graphics Core for rendering and user interactions
 #include "../Graphics/core.hpp"
@@ -13,21 +20,190 @@
 #include "../Engine/Math/core.hpp"
 
 #include "Random.hpp" // For generating random colors
+#include "TripleBuffer.hpp" // For handing snapshots from the physics thread to the renderer
+#include "SpscQueue.hpp" // For sending commands from the renderer to the physics thread
 
 namespace Utils {
 
     /**
      * @brief Simulation class for simulating a simple solar system with physics, rendering, and user interactions.
+     * @paragraph Physics runs on its own thread, started by the first update(). It advances the world in fixed
+     * time steps, as many per second as the speed asks for and the CPU allows.
+     * The render thread never touches the world once it runs: it draws the latest Snapshot the physics thread
+     * published, and pauses, warps and speed changes reach the physics thread as Commands.
      */
     class Simulation {
+    public:
+        /**
+         * @brief Immutable state of the world handed from the physics thread to the renderer.
+         */
+        struct Snapshot {
+            std::vector<Math::Vector> positions;  ///< Position of every body (m)
+            double time = 0.0;                    ///< Simulated time (s)
+            uint64_t steps = 0;                   ///< Steps taken so far
+            double stepsPerSecond = 0.0;          ///< Step rate over the last second of wall time
+            double speed = 0.0;                   ///< Simulated seconds per second of wall time achieved over the last second
+        };
+
+        /**
+         * @brief Message from the render thread to the physics thread.
+         */
+        struct Command {
+            /**
+             * @enum Type
+             * @brief What the command does (SetPaused, SetWarp, SetSpeed, SetTimeStep, SetStepBudget).
+             */
+            enum class Type { SetPaused, SetWarp, SetSpeed, SetTimeStep, SetStepBudget };
+
+            Type type = Type::SetPaused;
+            bool flag = false;          ///< SetPaused: whether physics should stop. SetWarp: whether to step flat out
+            double value = 0.0;         ///< SetSpeed: simulated s per wall s. SetTimeStep: dt (s). SetStepBudget: wall s
+        };
+
     protected:
         Graphics::Window window; ///< Window object for rendering and handling user interactions
+        Physics::World world; ///< Physics world, owned by the physics thread once update() has started it
         std::string scaleText; ///< Text to display scale information
         bool started = false; ///< Flag to toggle simulation start/stop
         bool showGrid = true; ///< Flag to toggle grid display
+        float gridSpacing; ///< Minimum distance between grid lines on screen, in pixels
         double speedFactor; ///< Speed factor for simulation
+        unsigned int warpFrames = 0; ///< Frames left to skip rendering in warp mode
 
     private:
+        static constexpr double publishInterval = 0.004; ///< Wall time between snapshots while stepping (s)
+        static constexpr unsigned int warpKeyFrames = 600; ///< Frames warped by the W key
+
+        std::thread physicsThread;                 ///< Runs physicsLoop()
+        std::atomic<bool> running{ false };        ///< Cleared to stop the physics thread
+        TripleBuffer<Snapshot> snapshots;          ///< Snapshots published by the physics thread
+        SpscQueue<Command, 64> commands;           ///< Commands waiting for the physics thread
+
+        // Owned by the physics thread once it runs
+        bool physicsPaused = true;                 ///< Whether the physics thread is stepping
+        bool physicsWarp = false;                  ///< Whether to step flat out, regardless of the speed
+        double physicsSpeed = 1e7;                 ///< Simulated seconds per second of wall time
+        double timeStep = 3600.0;                  ///< Fixed simulated time of every step (s)
+        double stepBudget = 0.004;                 ///< Wall time spent stepping before commands and snapshots are handled (s)
+        double accumulator = 0.0;                  ///< Simulated time owed to the world, less than timeStep once caught up (s)
+        uint64_t stepCount = 0;                    ///< Steps taken so far
+
+        /**
+         * @brief Applies a command to the physics state. Physics thread only once it runs.
+         * @param command The command to apply.
+         */
+        void apply(const Command& command) {
+            switch (command.type) {
+            case Command::Type::SetPaused: physicsPaused = command.flag; break;
+            case Command::Type::SetWarp: physicsWarp = command.flag; break;
+            case Command::Type::SetSpeed: physicsSpeed = command.value; break;
+            case Command::Type::SetTimeStep: timeStep = command.value; break;
+            case Command::Type::SetStepBudget: stepBudget = command.value; break;
+            }
+        }
+
+        /**
+         * @brief Fills the back snapshot from the world and publishes it. Physics thread only.
+         * @param stepsPerSecond The current step rate.
+         * @param speed The current speed achieved.
+         */
+        void publish(double stepsPerSecond, double speed) {
+            const Physics::BodyStorage& storage = world.getStorage();
+            Snapshot& snapshot = snapshots.write();
+
+            snapshot.positions.resize(storage.size());
+            for (size_t i = 0; i < storage.size(); i++) {
+                snapshot.positions[i] = Math::Vector(storage.x[i], storage.y[i]);
+            }
+            snapshot.time = world.getTime();
+            snapshot.steps = stepCount;
+            snapshot.stepsPerSecond = stepsPerSecond;
+            snapshot.speed = speed;
+
+            snapshots.publish();
+        }
+
+        /**
+         * @brief Body of the physics thread, until running is cleared.
+         * @paragraph Wall time times the speed is added to an accumulator, and fixed steps are taken while it holds
+         * a whole timeStep, for at most stepBudget of wall time before commands are read and a snapshot published
+         * again. If the budget runs out first the world cannot keep up: the backlog is dropped rather than carried,
+         * so the simulation runs slower than asked instead of falling further and further behind. In warp the
+         * accumulator is ignored and every budget is spent stepping.
+         */
+        void physicsLoop() {
+            using Clock = std::chrono::steady_clock;
+            Clock::time_point last = Clock::now(), lastPublish = last, rateStart = last;
+            uint64_t rateSteps = stepCount;
+            double rateTime = world.getTime();
+            double stepsPerSecond = 0.0, speed = 0.0;
+
+            while (running.load(std::memory_order_relaxed)) {
+                Command command;
+                bool changed = false;
+                while (commands.tryPop(command)) {
+                    apply(command);
+                    changed = true;
+                }
+
+                Clock::time_point now = Clock::now();
+                const double elapsed = std::chrono::duration<double>(now - last).count();
+                last = now;
+
+                if (!physicsPaused) {
+                    accumulator += elapsed * physicsSpeed;
+
+                    const Clock::time_point budgetEnd = now + std::chrono::duration_cast<Clock::duration>(
+                        std::chrono::duration<double>(stepBudget));
+                    while (physicsWarp || accumulator >= timeStep) {
+                        step(timeStep);
+                        stepCount++;
+                        accumulator -= timeStep;
+
+                        now = Clock::now();
+                        if (now >= budgetEnd) break;
+                    }
+                    if (physicsWarp || accumulator >= timeStep) accumulator = 0.0; // Out of budget, drop the backlog
+                }
+                else {
+                    accumulator = 0.0;
+                }
+
+                const double sinceRate = std::chrono::duration<double>(now - rateStart).count();
+                if (sinceRate >= 1.0) {
+                    stepsPerSecond = (stepCount - rateSteps) / sinceRate;
+                    speed = (world.getTime() - rateTime) / sinceRate;
+                    rateSteps = stepCount;
+                    rateTime = world.getTime();
+                    rateStart = now;
+                }
+
+                const bool due = !physicsPaused && std::chrono::duration<double>(now - lastPublish).count() >= publishInterval;
+                if (changed || due) {
+                    publish(stepsPerSecond, speed);
+                    lastPublish = now;
+                }
+
+                // Nothing to do until the next command or the next step is due
+                if (physicsPaused) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                else if (!physicsWarp) {
+                    const double wait = physicsSpeed > 0.0 ? (timeStep - accumulator) / physicsSpeed : 0.001;
+                    std::this_thread::sleep_for(std::chrono::duration<double>(std::min(wait, 0.001)));
+                }
+            }
+        }
+
+        /**
+         * @brief Sends a command to the physics thread, or applies it directly if the thread has not started.
+         * @param command The command to send.
+         */
+        void send(const Command& command) {
+            if (!physicsThread.joinable()) {
+                apply(command);
+                return;
+            }
+            while (!commands.tryPush(command)) std::this_thread::yield(); // Full only for a moment
+        }
 
         /**
          * @brief Displays the scale and paused state information.
@@ -41,6 +217,15 @@ namespace Utils {
                 window.writeText("Paused", sf::Vector2f(left + padding, top - padding),
                     Graphics::Color::White, 1, false, 0.7f); // Display "Paused" when simulation is stopped
             }
+            else {
+                // Display the speed and step rate the physics thread achieves
+                const Snapshot& snapshot = getSnapshot();
+                std::ostringstream oss;
+                oss << std::scientific << std::setprecision(1) << snapshot.speed << " s/s, "
+                    << std::fixed << std::setprecision(0) << snapshot.stepsPerSecond << " steps/s";
+                window.writeText(oss.str(), sf::Vector2f(left + padding, top - padding),
+                    Graphics::Color::White, 1, false, 0.7f);
+            }
 
             float bottom = window.getCameraBottom();
 
@@ -62,12 +247,46 @@ namespace Utils {
          */
         Simulation(const std::string& title, unsigned int width = 1280, unsigned int height = 768,
             Graphics::Color bgColor = Graphics::Color::Black, float zoom = 5.0f, unsigned int gridSpacing = 32)
-            : window(width, height, title, bgColor, zoom, gridSpacing) {
+            : window(width, height, title, bgColor, zoom), gridSpacing(static_cast<float>(gridSpacing)) {
             speedFactor = 1e7; // Set the speed factor for the simulation
             // Load a font for text rendering
             Graphics::Text::loadFont("Resources/Fonts/Roboto-Regular.ttf");
         }
 
+        /**
+         * @brief Stops the physics thread.
+         */
+        virtual ~Simulation() {
+            stop();
+        }
+
+        Simulation(const Simulation&) = delete;
+        Simulation& operator=(const Simulation&) = delete;
+
+        /**
+         * @brief Starts the physics thread if it is not running. Called by the first update().
+         * @paragraph From here on only the physics thread may touch the world.
+         */
+        void start() {
+            if (physicsThread.joinable()) return;
+
+            publish(0.0, 0.0); // The renderer has the initial state before the first step
+            snapshots.update();
+
+            running = true;
+            physicsThread = std::thread(&Simulation::physicsLoop, this);
+        }
+
+        /**
+         * @brief Stops and joins the physics thread. Subclasses that override step() must call it in their
+         * destructor, so the thread does not call into a destroyed object.
+         */
+        void stop() {
+            if (!physicsThread.joinable()) return;
+            running = false;
+            physicsThread.join();
+        }
+
 
 
         /**
@@ -87,18 +306,80 @@ namespace Utils {
         }
 
         /**
-         * @brief Sets the speed factor for the simulation.
+         * @brief Sets the speed factor for the simulation, 10^factor simulated seconds per second of wall time.
+         * @paragraph The time step does not change: a higher speed takes more steps per second, up to what the CPU allows.
          * @param factor Speed factor value.
          */
         void setSpeed(double factor) {
-            Math::Operation::Clamp(factor, 0.0, 15.0); // Clamp the factor between 0 and 15
+            factor = Math::Operation::Clamp(factor, 0.0, 15.0); // Clamp the factor between 0 and 15
             speedFactor = std::pow(10, factor); // Set the speed factor for the simulation
+
+            Command command;
+            command.type = Command::Type::SetSpeed;
+            command.value = speedFactor;
+            send(command);
         }
 
         /**
-         * @brief Updates the simulation state, processing events and advancing the simulation.
+         * @brief Sets the fixed simulated time advanced by every step.
+         * @param time The time step (s), 3600 by default.
+         * @throws std::invalid_argument if time is not positive.
+         */
+        void setTimeStep(double time) {
+            if (!(time > 0.0)) throw std::invalid_argument("Time step must be positive");
+
+            Command command;
+            command.type = Command::Type::SetTimeStep;
+            command.value = time;
+            send(command);
+        }
+
+        /**
+         * @brief Sets the wall time the physics thread may spend stepping before it reads commands and publishes a snapshot.
+         * @paragraph A step that takes longer is finished first. When the steps owed do not fit in the budget, the rest
+         * are dropped and the simulation runs slower than the speed asks for.
+         * @param seconds The budget (s), 0.004 by default.
+         * @throws std::invalid_argument if seconds is not positive.
+         */
+        void setStepBudget(double seconds) {
+            if (!(seconds > 0.0)) throw std::invalid_argument("Step budget must be positive");
+
+            Command command;
+            command.type = Command::Type::SetStepBudget;
+            command.value = seconds;
+            send(command);
+        }
+
+        /**
+         * @brief Skips rendering for the given number of frames, while the physics thread steps as fast as it can
+         * regardless of the speed. warp(0) ends a warp early.
+         * @param frames The number of frames to skip.
+         */
+        void warp(unsigned int frames) {
+            if ((frames > 0) != (warpFrames > 0)) {
+                Command command;
+                command.type = Command::Type::SetWarp;
+                command.flag = frames > 0;
+                send(command);
+            }
+            warpFrames = frames;
+        }
+
+        /**
+         * @brief Checks whether the simulation is warping. draw() does nothing while it is.
+         * @return True if frames are being skipped.
+         */
+        bool isWarping() const {
+            return warpFrames > 0;
+        }
+
+        /**
+         * @brief Processes window events, forwarding pauses and warps to the physics thread, and takes the
+         * newest snapshot for drawing. Starts the physics thread on the first call.
          */
         void update() {
+            start();
+
             sf::Event event;
             while (window.pollEvent(event)) {
                 if (event.type == sf::Event::Closed) window.close();
@@ -111,22 +392,47 @@ namespace Utils {
 
                 if (event.type == sf::Event::KeyPressed) {
                     // Toggle simulation start/stop
-                    if (event.key.code == sf::Keyboard::Space) started = !started;
+                    if (event.key.code == sf::Keyboard::Space) {
+                        started = !started;
+
+                        Command command;
+                        command.type = Command::Type::SetPaused;
+                        command.flag = !started;
+                        send(command);
+                    }
                     // Handle grid toggle with G key
                     if (event.key.code == sf::Keyboard::G) showGrid = !showGrid;
+                    // Toggle warp with W key
+                    if (event.key.code == sf::Keyboard::W) warp(isWarping() ? 0 : warpKeyFrames);
                 }
             }
 
-            if (started) step(); // Step through the simulation if started
+            // Warped frames are not displayed, so wait out the frame here instead of in display()
+            if (isWarping()) {
+                std::this_thread::sleep_for(std::chrono::microseconds(16667));
+                warp(warpFrames - 1);
+            }
+
+            snapshots.update(); // Draw the newest state the physics thread has published
             window.update(); // Update the window
         }
 
+        /**
+         * @brief Advances the world by the given time. Runs on the physics thread, so it may only touch the world.
+         * @paragraph Override for custom physics; the override's class must call stop() in its destructor.
+         * @param time The simulated time to advance (s).
+         */
+        virtual void step(double time) {
+            world.step(time);
+        }
 
         /**
-         * @brief Steps through the simulation logic provided by the user.
-         * @paragraph This function should be overridden by the user to define the simulation logic.
+         * @brief Gets the snapshot to draw, the newest one as of the last update().
+         * @return The snapshot, unchanged until the next update().
          */
-        virtual void step() = 0;
+        const Snapshot& getSnapshot() const {
+            return snapshots.read();
+        }
 
         /**
          * @brief Virtual method to draw the objects in the simulation. Must be overridden by the user.
@@ -139,13 +445,16 @@ namespace Utils {
          * @paragraph This function can be overridden by the user for more control over the drawing process.
          */
         virtual void draw() {
+            if (isWarping()) return; // Skip rendering while warping
+
             window.clear(); // Clear the window
 
             // Draw grid lines
-            if (showGrid) window.drawGridLines(1.0f, Graphics::Color("#333333"));
+            if (showGrid) window.drawGridLines(1.0f, Graphics::Color("#333333"), gridSpacing);
 
-            // Draw celestial bodies
+            // Draw celestial bodies, then flush whatever they batched so the text goes on top
             draw_bodies();
+            window.flushBatch();
 
             displayScale(); // Display scale text
             window.display(); // Display everything on the window
@@ -0,0 +1,67 @@
+#ifndef SPSC_QUEUE_HPP
+#define SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+
+namespace Utils {
+
+    /**
+     * @class SpscQueue
+     * @brief Bounded lock-free queue between exactly one producer thread and one consumer thread.
+     * @paragraph Items are copied into a fixed ring, so pushing and popping never allocate or block:
+     * they fail instead when the queue is full or empty.
+     * @tparam T The type of the items, copied in and out.
+     * @tparam Capacity The number of items the queue holds, a power of two.
+     */
+    template <typename T, size_t Capacity>
+    class SpscQueue {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+    private:
+        // The indices only grow and wrap around the ring through the mask. Each sits on its own cache line
+        // so the two threads do not invalidate each other's line on every operation.
+        alignas(64) std::atomic<size_t> head{ 0 }; ///< Next item to pop, written by the consumer
+        alignas(64) std::atomic<size_t> tail{ 0 }; ///< Next slot to push into, written by the producer
+        alignas(64) T items[Capacity];             ///< The ring
+
+    public:
+        /**
+         * @brief Appends an item. Producer only.
+         * @param item The item to append.
+         * @return False if the queue is full, in which case nothing is appended.
+         */
+        bool tryPush(const T& item) {
+            const size_t t = tail.load(std::memory_order_relaxed);
+            if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+
+            items[t & (Capacity - 1)] = item;
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Removes the oldest item. Consumer only.
+         * @param item Receives the item.
+         * @return False if the queue is empty, in which case item is left unchanged.
+         */
+        bool tryPop(T& item) {
+            const size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire)) return false;
+
+            item = items[h & (Capacity - 1)];
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Checks whether the queue is empty. Exact only on the consumer thread.
+         * @return True if there is nothing to pop.
+         */
+        bool empty() const {
+            return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+        }
+    };
+}
+
+#endif // SPSC_QUEUE_HPP
@@ -0,0 +1,158 @@
+#ifndef TRAIL_HPP
+#define TRAIL_HPP
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#include "../Graphics/core.hpp"
+#include "../Engine/Physics/core.hpp"
+#include "../Engine/Math/core.hpp"
+
+namespace Utils {
+
+    /**
+     * @class Trail
+     * @brief Trail of a body for drawing: a Physics::Path and a copy of it simplified for the current zoom level.
+     * @paragraph The simplified copy drops every point that moves the polyline by less than half a pixel
+     * (Douglas-Peucker), so a long orbit seen from afar costs a handful of segments. It is kept between frames and
+     * rebuilt only when the zoom level changes or the path thins its old points. Points appended since are drawn
+     * as they are until a chunk of them has gathered, which is then simplified and added to the copy.
+     */
+    class Trail {
+    private:
+        static constexpr size_t chunk = 32;            ///< Raw points gathered before they are simplified
+        static constexpr float pixelTolerance = 0.5f;  ///< Largest deviation of the simplified polyline (pixels)
+
+        Physics::Path path;                            ///< The trail itself
+        std::vector<sf::Vector2f> simplified;          ///< Screen points of path[0, covered) after simplification
+        size_t covered = 0;                            ///< Path points simplified so far, the last one is simplified.back()
+        size_t revision = 0;                           ///< Path revision simplified was built from
+        float tolerance = -1.0f;                       ///< Tolerance simplified was built with, negative before the first build
+
+        // Scratch space, kept to avoid allocating every frame
+        std::vector<sf::Vector2f> points;                    ///< Screen points being simplified or drawn
+        std::vector<uint8_t> keep;                           ///< Whether each of points survives simplification
+        std::vector<std::pair<size_t, size_t>> ranges;       ///< Pending ranges of the Douglas-Peucker recursion
+
+        /**
+         * @brief Loads the screen positions of path[begin, end) into points.
+         */
+        void load(size_t begin, size_t end) {
+            points.resize(end - begin);
+            for (size_t i = begin; i < end; i++) points[i - begin] = Math::Converter::toVector2f(path.get(static_cast<int>(i)));
+        }
+
+        /**
+         * @brief Simplifies points with Douglas-Peucker and appends the survivors to simplified, skipping the first point
+         * if it is already there. The recursion runs on an explicit stack, so long trails cannot overflow the call stack.
+         * @param skipFirst Whether points.front() is simplified.back().
+         */
+        void simplify(bool skipFirst) {
+            const size_t n = points.size();
+            keep.assign(n, 0);
+            keep.front() = keep.back() = 1;
+
+            const float tolerance2 = tolerance * tolerance;
+            ranges.clear();
+            if (n > 2) ranges.emplace_back(0, n - 1);
+            while (!ranges.empty()) {
+                const auto [first, last] = ranges.back();
+                ranges.pop_back();
+
+                // Farthest point from the chord first-last, measured to the segment so closed loops work
+                const sf::Vector2f a = points[first];
+                const sf::Vector2f chord = points[last] - a;
+                const float length2 = chord.x * chord.x + chord.y * chord.y;
+
+                float farthest2 = -1.0f;
+                size_t farthest = first;
+                for (size_t i = first + 1; i < last; i++) {
+                    sf::Vector2f offset = points[i] - a;
+                    if (length2 > 0.0f) {
+                        const float t = std::fmin(std::fmax((offset.x * chord.x + offset.y * chord.y) / length2, 0.0f), 1.0f);
+                        offset = offset - chord * t;
+                    }
+                    const float distance2 = offset.x * offset.x + offset.y * offset.y;
+                    if (distance2 > farthest2) {
+                        farthest2 = distance2;
+                        farthest = i;
+                    }
+                }
+
+                if (farthest2 <= tolerance2) continue;
+                keep[farthest] = 1;
+                if (farthest - first > 1) ranges.emplace_back(first, farthest);
+                if (last - farthest > 1) ranges.emplace_back(farthest, last);
+            }
+
+            for (size_t i = skipFirst ? 1 : 0; i < n; i++) {
+                if (keep[i]) simplified.push_back(points[i]);
+            }
+        }
+
+    public:
+        /**
+         * @brief Constructs an empty trail.
+         * @param capacity The number of points the path holds before it thins its old points.
+         * @param minDistance The distance a body moves before a new point is taken (m).
+         */
+        Trail(size_t capacity = 1024, double minDistance = 0.0) : path(capacity, minDistance) {}
+
+        /**
+         * @brief Adds a position to the trail.
+         * @param position The position of the body (m).
+         */
+        void insert(const Math::Vector& position) {
+            path.insert(position);
+        }
+
+        /**
+         * @brief Gets the path behind the trail.
+         * @return The path.
+         */
+        Physics::Path& getPath() {
+            return path;
+        }
+
+        /**
+         * @brief Batches the trail into the window at the window's current zoom level.
+         * Segments outside the camera's view are culled by the window.
+         * @param window The window to draw to.
+         * @param color The color of the trail.
+         */
+        void draw(Graphics::Window& window, Graphics::Color color) {
+            const size_t n = path.getSize();
+            const float currentTolerance = window.getPixelSize() * pixelTolerance;
+
+            // Rebuild on zoom, or when old points changed under the cache
+            if (currentTolerance != tolerance || path.getRevision() != revision || covered == 0 || covered > n) {
+                tolerance = currentTolerance;
+                revision = path.getRevision();
+                simplified.clear();
+                covered = 0;
+                if (n > 0) {
+                    load(0, n);
+                    simplify(false);
+                    covered = n;
+                }
+            }
+            else if (n - covered >= chunk) {
+                load(covered - 1, n);
+                simplify(true);
+                covered = n;
+            }
+
+            window.batchLineStrip(simplified, color);
+
+            // Points appended since the last simplification, joined to the simplified part
+            if (n > covered && covered > 0) {
+                load(covered - 1, n);
+                window.batchLineStrip(points, color);
+            }
+        }
+    };
+}
+
+#endif // TRAIL_HPP
@@ -0,0 +1,65 @@
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+namespace Utils {
+
+    /**
+     * @class TripleBuffer
+     * @brief Lock-free hand-off of the latest value from one producer thread to one consumer thread.
+     * @paragraph The producer fills the back buffer and publishes it, the consumer reads the front buffer and
+     * picks up the newest published one when it wants. The third buffer sits between them, so neither side
+     * ever waits for the other: a slow consumer only skips values, a slow producer only repeats them.
+     * Buffers are reused, so values holding vectors stop allocating once they have grown.
+     * @tparam T The type of the values handed over.
+     */
+    template <typename T>
+    class TripleBuffer {
+    private:
+        static constexpr uint8_t IndexMask = 0x3; ///< Bits of the middle state holding a buffer index
+        static constexpr uint8_t Fresh = 0x4;     ///< Set in the middle state when it holds a value not yet read
+
+        T buffers[3];                       ///< The three buffers
+        std::atomic<uint8_t> middle{ 1 };   ///< Index of the middle buffer, and whether it is fresh
+        uint8_t back = 0;                   ///< Buffer being written, owned by the producer
+        uint8_t front = 2;                  ///< Buffer being read, owned by the consumer
+
+    public:
+        /**
+         * @brief Gets the buffer to fill. Producer only.
+         * @return The back buffer, still holding the value it had when it was last published.
+         */
+        T& write() {
+            return buffers[back];
+        }
+
+        /**
+         * @brief Publishes the back buffer and takes the middle one as the new back buffer. Producer only.
+         */
+        void publish() {
+            back = middle.exchange(back | Fresh, std::memory_order_acq_rel) & IndexMask;
+        }
+
+        /**
+         * @brief Makes the newest published value the front buffer, if there is one. Consumer only.
+         * @return True if the front buffer changed, false if nothing was published since the last update.
+         */
+        bool update() {
+            if (!(middle.load(std::memory_order_relaxed) & Fresh)) return false;
+            front = middle.exchange(front, std::memory_order_acq_rel) & IndexMask;
+            return true;
+        }
+
+        /**
+         * @brief Gets the front buffer. Consumer only. It does not change until the next update().
+         * @return The value published most recently as of the last update().
+         */
+        const T& read() const {
+            return buffers[front];
+        }
+    };
+}
+
+#endif // TRIPLE_BUFFER_HPP